@@ -0,0 +1,99 @@
+// **************************************************************************
+// barcode_bench
+// 19.10.2026
+// Throughput of barcode generation for large PDF417 messages
+// **************************************************************************
+// MIT License
+// Copyright © 2021 Patrick Fial
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions: The above copyright notice and this
+// permission notice shall be included in all copies or substantial portions of the Software. THE
+// SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+// LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// **************************************************************************
+// includes
+// **************************************************************************
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QString>
+
+#include <cstdio>
+
+#include "../src/barcode.h"
+
+// **************************************************************************
+// message
+// **************************************************************************
+
+// a ticket-like payload of the given length. latin1 messages contain umlauts, so the
+// iso-8859-1 path has to keep them as single bytes.
+
+static QString message(int length, bool latin1)
+{
+    const QString chunk = latin1 ? QString::fromUtf8("Zürich Hbf > Genève, Wagen 7, Platz 42; ")
+                                 : QString::fromUtf8("Zürich Hbf > Genève, Wagen 7 ✈ 42; ");
+    QString res;
+
+    while (res.size() < length)
+        res += chunk;
+
+    return res.left(length);
+}
+
+// **************************************************************************
+// run
+// **************************************************************************
+
+static void run(const char* name, const QString& text, const QString& encoding, int iterations)
+{
+    QImage image;
+    QString err = passes::BarcodeGenerator::generate(text, "PKBarcodeFormatPDF417", encoding,
+                                                     &image);
+
+    if (!err.isEmpty()) {
+        printf("%-24s failed: %s\n", name, qPrintable(err));
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int i = 0; i < iterations; i++)
+        passes::BarcodeGenerator::generate(text, "PKBarcodeFormatPDF417", encoding, &image);
+
+    double seconds = timer.nsecsElapsed() / 1e9;
+
+    printf("%-24s %5d chars  %8.1f barcodes/s  %8.1f kchars/s\n", name, text.size(),
+           iterations / seconds, iterations * text.size() / seconds / 1000.0);
+}
+
+// **************************************************************************
+// main
+// **************************************************************************
+
+// usage: barcode_bench [iterations]
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    int iterations = argc > 1 ? QString(argv[1]).toInt() : 200;
+
+    for (int length : {100, 400, 800}) {
+        run("iso-8859-1", message(length, true), "iso-8859-1", iterations);
+        run("utf-8", message(length, false), "utf-8", iterations);
+        run("undeclared", message(length, false), "", iterations);
+        run("iso-8859-1 fallback", message(length, false), "iso-8859-1", iterations);
+    }
+
+    return 0;
+}
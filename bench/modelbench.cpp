@@ -0,0 +1,140 @@
+// **************************************************************************
+// model_bench
+// 19.10.2026
+// data() calls per second of PassesModel for every role
+// **************************************************************************
+// MIT License
+// Copyright © 2021 Patrick Fial
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions: The above copyright notice and this
+// permission notice shall be included in all copies or substantial portions of the Software. THE
+// SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+// LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// **************************************************************************
+// includes
+// **************************************************************************
+
+#include <QElapsedTimer>
+#include <QGuiApplication>
+
+#include <cstdio>
+
+#include "../src/passesmodel.h"
+
+using namespace passes;
+
+// **************************************************************************
+// makePass
+// **************************************************************************
+
+// a parsed pass as the store would hand it out, without images
+
+static PassPtr makePass(int index)
+{
+    auto pass = std::make_shared<Pass>();
+    auto number = QString::number(index);
+
+    pass->id = "bench" + number;
+    pass->modified = QDateTime::currentDateTime().addSecs(-index * 3600);
+    pass->sortingDate = pass->modified;
+    pass->filePath = "/nonexistent/" + pass->id + ".pkpass";
+    pass->bundleExpired = false;
+    pass->bundleIndex = -1;
+    pass->haveStripImage = false;
+    pass->haveBackgroundImage = false;
+
+    Standard& standard = pass->standard;
+    standard.description = "Boarding pass " + number;
+    standard.organization = "Airline " + QString::number(index % 7);
+    standard.passTypeIdentifier = "pass.bench.boarding";
+    standard.serialNumber = number;
+    standard.voided = false;
+    standard.expired = false;
+    standard.maxDistance = 0;
+    standard.backgroundColor = "#1a3b5c";
+    standard.foregroundColor = "#ffffff";
+    standard.labelColor = "#c0c0c0";
+    standard.barcodeFormat = "PKBarcodeFormatPDF417";
+    standard.barcodes << Barcode {"PKBarcodeFormatPDF417", "M1BENCH/PASS " + number,
+                                  "iso-8859-1", number};
+
+    pass->details.style = "boardingPass";
+    pass->details.transitType = "PKTransitTypeAir";
+    pass->details.maxFieldLabelWidth = 0.0;
+
+    for (auto fields : {&pass->details.headerFields, &pass->details.primaryFields,
+                        &pass->details.secondaryFields, &pass->details.backFields})
+        *fields << PassStyleField {"key", "Value " + number, "Label"};
+
+    pass->webservice.webserviceBroken = false;
+    pass->updateSortKeys();
+
+    return pass;
+}
+
+// **************************************************************************
+// main
+// **************************************************************************
+
+// usage: model_bench [passes] [rounds]
+
+int main(int argc, char* argv[])
+{
+    QGuiApplication app(argc, argv);
+
+    int count = argc > 1 ? QString(argv[1]).toInt() : 500;
+    int rounds = argc > 2 ? QString(argv[2]).toInt() : 200;
+
+    PassList passes;
+
+    for (int i = 0; i < count; i++)
+        passes.push_back(makePass(i));
+
+    // handed over the way the store delivers loaded passes
+
+    PassesModel model;
+    QMetaObject::invokeMethod(&model, "storeLoaded", Qt::DirectConnection, Q_ARG(PassList, passes),
+                              Q_ARG(QVariantList, QVariantList()));
+
+    if (model.rowCount() != count) {
+        printf("model holds %d of %d passes\n", model.rowCount(), count);
+        return 1;
+    }
+
+    auto roles = model.roleNames();
+    qint64 total = 0, totalNsecs = 0;
+
+    for (auto it = roles.cbegin(); it != roles.cend(); ++it) {
+        // the first round creates the pass objects, it is not timed
+
+        for (int row = 0; row < count; row++)
+            model.data(model.index(row), it.key());
+
+        QElapsedTimer timer;
+        timer.start();
+
+        for (int round = 0; round < rounds; round++) {
+            for (int row = 0; row < count; row++)
+                model.data(model.index(row), it.key());
+        }
+
+        qint64 nsecs = timer.nsecsElapsed();
+        qint64 calls = qint64(rounds) * count;
+
+        printf("%-18s %12.0f calls/s\n", it.value().constData(), calls / (nsecs / 1e9));
+
+        total += calls;
+        totalNsecs += nsecs;
+    }
+
+    printf("%-18s %12.0f calls/s\n", "all roles", total / (totalNsecs / 1e9));
+
+    return 0;
+}
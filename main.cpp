@@ -13,10 +13,26 @@ int main(int argc, char *argv[])
     app->setApplicationName("passes.s710");
 
     qmlRegisterType<passes::PassesModel>("PassesModel", 1, 0, "PassesModel");
+    qmlRegisterUncreatableType<passes::PassObject>("PassesModel", 1, 0, "Pass",
+                                                   "Passes are provided by PassesModel");
+    qmlRegisterUncreatableType<passes::FieldsModel>("PassesModel", 1, 0, "FieldsModel",
+                                                    "Fields are provided by Pass");
+    qmlRegisterUncreatableType<passes::BundleModel>("PassesModel", 1, 0, "BundleModel",
+                                                    "Bundles are provided by Pass");
+    qmlRegisterUncreatableType<passes::StandardObject>("PassesModel", 1, 0, "Standard",
+                                                       "Standard keys are provided by Pass");
+    qmlRegisterUncreatableType<passes::DetailsObject>("PassesModel", 1, 0, "Details",
+                                                      "Details are provided by Pass");
 
     QQuickView *view = new QQuickView();
     QQmlEngine *engine = view->engine();
-    engine->addImageProvider(QLatin1String("passes"), new passes::PassImageProvider());
+    auto imageProvider = new passes::PassImageProvider();
+    engine->addImageProvider(QLatin1String("passes"), imageProvider);
+
+    imageProvider->setDevicePixelRatio(view->devicePixelRatio());
+    QObject::connect(view, &QWindow::screenChanged, [view, imageProvider]() {
+        imageProvider->setDevicePixelRatio(view->devicePixelRatio());
+    });
 
     view->setSource(QUrl("qrc:/Main.qml"));
     view->setResizeMode(QQuickView::SizeRootObjectToView);
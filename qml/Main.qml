@@ -20,6 +20,7 @@ MainView {
 
    property string initError: ""
    property var failedPasses: undefined
+   property alias appSettings: settings
 
    // width: units.gu(45)
    // height: units.gu(75)
@@ -27,6 +28,8 @@ MainView {
    Settings {
       id: settings
       property bool updateAtStartup: true
+      property int imageCacheSize: 64
+      property int sortMode: 0
    }
 
    Notification {
@@ -62,18 +65,7 @@ MainView {
                                                       LomiriColors.red)
 
                popup.accepted.connect(function() {
-                  var err = passesModel.deleteFile(pass.filePath)
-
-                  if (err) {
-                     var comps = (pass.filePath || "").split("/")
-                     var fileName = comps.length && comps[comps.length-1]
-
-                     Dialogs.showErrorDialog(mainPage,
-                                               i18n.tr("Failed to delete pass"),
-                                               i18n.tr("Pass '%1' could not be deleted (%2).")
-                                               .arg(fileName)
-                                               .arg(err))
-                  }
+                  passesModel.deleteFile(pass.filePath)
                })
             })
 
@@ -91,27 +83,60 @@ MainView {
       id: passesModel
 
       defaultFont: text.font
+      imageCacheSize: settings.imageCacheSize
 
       onFailedPasses: {
          root.failedPasses = passes
       }
+
+      onInitialized: {
+         root.initError = error
+
+         if (!root.initError)
+            passesModel.reload()
+         else
+            initTimer.start()
+      }
+
+      onPassesLoaded: initTimer.start()
+
+      onFileDeleted: {
+         if (error) {
+            var comps = (filePath || "").split("/")
+            var fileName = comps.length && comps[comps.length-1]
+
+            Dialogs.showErrorDialog(mainPage,
+                                      i18n.tr("Failed to delete pass"),
+                                      i18n.tr("Pass '%1' could not be deleted (%2).")
+                                      .arg(fileName)
+                                      .arg(error))
+         }
+      }
+   }
+
+   Binding {
+      target: passesModel.visiblePasses
+      property: "sortMode"
+      value: settings.sortMode
    }
 
    Connections {
       target: ContentHub
 
       onImportRequested: {
-         var filePath = String(transfer.items[0].url).replace('file://', '')
-         var fileName = filePath.split("/").pop();
+         var filePaths = transfer.items.map(function(item) { return String(item.url).replace('file://', '') })
+         var fileName = filePaths.length && filePaths[0].split("/").pop();
          var popup = Dialogs.showQuestionDialog(root,
                                                 i18n.tr("Add pass"),
-                                                i18n.tr("Do you want to add '%1' to Passes?").arg(fileName),
+                                                filePaths.length > 1
+                                                ? i18n.tr("Do you want to add %1 passes to Passes?").arg(filePaths.length)
+                                                : i18n.tr("Do you want to add '%1' to Passes?").arg(fileName),
                                                 i18n.tr("Add"),
                                                 i18n.tr("Cancel"),
                                                 LomiriColors.green)
 
          popup.accepted.connect(function() {
-            passesModel.importPass(filePath)
+            passesModel.importPasses(filePaths)
          })
       }
    }
@@ -124,13 +149,7 @@ MainView {
 
       Component.onCompleted: {
          push(mainPage)
-
-         root.initError = passesModel.init()
-
-         if (!root.initError)
-            passesModel.reload()
-
-         initTimer.start()
+         passesModel.init()
       }
 
       MainPage {
@@ -22,7 +22,7 @@ Page {
       handler: ContentHandler.Source
 
       onPeerSelected: {
-         peer.selectionType = ContentTransfer.Single
+         peer.selectionType = ContentTransfer.Multiple
          picker.activeTransfer = peer.request()
          picker.activeTransfer.stateChanged.connect(function() {
             if (!picker.activeTransfer)
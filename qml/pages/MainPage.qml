@@ -4,6 +4,7 @@ import QtQuick.Layouts 1.3
 import Qt.labs.settings 1.0
 import Qt.labs.platform 1.1
 import Lomiri.Content 1.1
+import QtPositioning 5.12
 
 import "../notify"
 import "../pass"
@@ -26,6 +27,16 @@ Page {
             visible: !!passesView.selectedPass
             onTriggered: passesView.dismissCard()
          },
+         Action {
+            iconName: "find"
+            visible: !passesView.selectedPass
+            onTriggered: passesView.searching = !passesView.searching
+         },
+         Action {
+            iconName: "location"
+            visible: !passesView.selectedPass
+            onTriggered: passesView.nearby = !passesView.nearby
+         },
          Action {
             iconName: "import"
             visible: !passesView.selectedPass
@@ -57,7 +68,8 @@ Page {
             iconName: "settings"
             visible: !passesView.selectedPass
             onTriggered: {
-               var settingsPage = pageStack.push(Qt.resolvedUrl("SettingsPage.qml"), {})
+               var settingsPage = pageStack.push(Qt.resolvedUrl("SettingsPage.qml"),
+                                                 { passesModel: passesModel, appSettings: root.appSettings })
 
                settingsPage.updateIntervalChanged.connect(function(interval, enabled) {
                   fetchUpdatesTimer.running = enabled
@@ -73,17 +85,7 @@ Page {
             visible: !!passesView.selectedPass
             onTriggered: {
                if (passesView.selectedPass.bundleName.length) {
-                  var res = passesModel.createExportBundle(passesView.selectedPass.id)
-
-                  if (res.error) {
-                     Dialogs.showErrorDialog(mainPage,
-                           i18n.tr("Failed to export pass bundle"),
-                           i18n.tr("Pass bundle could not be exported (%1).")
-                           .arg(res.error))
-                  } else if (res.filePath) {
-                     var sharePage = Qt.resolvedUrl("SharePage.qml")
-                     pageStack.push(sharePage, { url: "file://" + res.filePath, model: passesModel, cleanupFile: res.filePath })
-                  }
+                  passesModel.createExportBundle(passesView.selectedPass.id)
                } else {
                   var passFile = passesView.selectedPass.filePath
 
@@ -104,20 +106,8 @@ Page {
                                                       LomiriColors.red)
 
                popup.accepted.connect(function() {
-                  var passFile = passesView.selectedPass.filePath;
-                  var err = passesModel.deletePass(passesView.selectedPass.id)
+                  passesModel.deletePass(passesView.selectedPass.id)
                   passesView.dismissCard()
-
-                  if (err) {
-                     var comps = (passFile || "").split("/")
-                     var fileName = comps.length && comps[comps.length-1]
-
-                     Dialogs.showErrorDialog(mainPage,
-                                               i18n.tr("Failed to delete pass"),
-                                               i18n.tr("Pass '%1' could not be deleted (%2).")
-                                               .arg(fileName)
-                                               .arg(err))
-                  }
                })
             }
          }
@@ -129,6 +119,51 @@ Page {
       onPassUpdatesFetched: {
          passesView.showActivity = false
       }
+
+      onImportProgress: {
+         passesView.showActivity = done < total
+      }
+
+      onImportFinished: {
+         passesView.showActivity = false
+      }
+
+      onImportFailed: {
+         passes.forEach(function(pass) {
+            var comps = ((pass.filePath || "") + '').split("/")
+            var fileName = comps.length && comps[comps.length-1]
+
+            Dialogs.showErrorDialog(mainPage,
+                                      i18n.tr("Failed to import pass"),
+                                      i18n.tr("Pass '%1' could not be imported (%2).")
+                                      .arg(fileName)
+                                      .arg(pass.error))
+         })
+      }
+
+      onPassDeleted: {
+         if (error) {
+            var comps = (filePath || "").split("/")
+            var fileName = comps.length && comps[comps.length-1]
+
+            Dialogs.showErrorDialog(mainPage,
+                                      i18n.tr("Failed to delete pass"),
+                                      i18n.tr("Pass '%1' could not be deleted (%2).")
+                                      .arg(fileName)
+                                      .arg(error))
+         }
+      }
+
+      onBundleExported: {
+         if (error) {
+            Dialogs.showErrorDialog(mainPage,
+                  i18n.tr("Failed to export pass bundle"),
+                  i18n.tr("Pass bundle could not be exported (%1).")
+                  .arg(error))
+         } else if (filePath) {
+            pageStack.push(Qt.resolvedUrl("SharePage.qml"), { url: "file://" + filePath })
+         }
+      }
    }
 
    Settings {
@@ -137,6 +172,17 @@ Page {
       property double updateInterval: 15
    }
 
+   PositionSource {
+      id: positionSource
+      active: passesView.nearby
+      updateInterval: 60000
+
+      onPositionChanged: {
+         if (position.latitudeValid && position.longitudeValid)
+            passesModel.setPosition(position.coordinate.latitude, position.coordinate.longitude)
+      }
+   }
+
    Timer {
       id: fetchUpdatesTimer
       interval: settings.updateInterval * 60000
@@ -163,7 +209,7 @@ Page {
       radius: units.gu(4)
       border.width: 2
       border.color: "gray"
-      visible: !passesModel.count
+      visible: !passesView.count && !passesView.searching && !passesView.nearby
 
       anchors.centerIn: parent
       width: parent.width * 0.6
@@ -195,19 +241,6 @@ Page {
    }
 
    function importUrls(urls) {
-      urls.forEach(function(fileUrl) {
-         var err = passesModel.importPass(fileUrl, passesView.showExpiredPasses)
-
-         if (err) {
-            var comps = ((fileUrl || "") + '').split("/")
-            var fileName = comps.length && comps[comps.length-1]
-
-            Dialogs.showErrorDialog(mainPage,
-                                      i18n.tr("Failed to import pass"),
-                                      i18n.tr("Pass '%1' could not be imported (%2).")
-                                      .arg(fileName)
-                                      .arg(err))
-         }
-      })
+      passesModel.importPasses(urls.map(String))
    }
 }
@@ -8,6 +8,9 @@ import Qt.labs.settings 1.0
 Page {
     id: settingsPage
     anchors.fill: parent
+    property var passesModel
+    property var appSettings // the settings the app binds to, written here only
+    property var cacheStats: passesModel ? passesModel.imageCacheStats() : ({})
     signal updateIntervalChanged(var interval, var enabled)
 
     Settings {
@@ -16,6 +19,13 @@ Page {
        property bool updateAtInterval: true
     }
 
+    Timer {
+       interval: 1000
+       repeat: true
+       running: !!settingsPage.passesModel
+       onTriggered: settingsPage.cacheStats = settingsPage.passesModel.imageCacheStats()
+    }
+
     header: PageHeader {
        id: header
        title: i18n.tr("Settings")
@@ -139,6 +149,87 @@ Page {
                  }
               }
           }
+
+          ListItem {
+             height: l7.height + (divider.visible ? divider.height : 0)
+
+             ListItemLayout {
+                id: l7
+                title.text: i18n.tr("Sorting")
+                title.font.bold: true
+                title.color: Theme.palette.normal.baseText
+             }
+          }
+
+          ListItem {
+              anchors.left: parent.left
+              anchors.right: parent.right
+              height: l8.height + (divider.visible ? divider.height : 0)
+
+              SlotsLayout {
+                 id: l8
+                 mainSlot: OptionSelector {
+                    text: i18n.tr("Sort passes by")
+                    model: [ i18n.tr("Date"), i18n.tr("Organization"), i18n.tr("Expiration date"), i18n.tr("Type") ]
+                    selectedIndex: settingsPage.appSettings.sortMode
+
+                    onSelectedIndexChanged: settingsPage.appSettings.sortMode = selectedIndex
+                 }
+              }
+          }
+
+          ListItem {
+             height: l5.height + (divider.visible ? divider.height : 0)
+
+             ListItemLayout {
+                id: l5
+                title.text: i18n.tr("Memory")
+                title.font.bold: true
+                title.color: Theme.palette.normal.baseText
+             }
+          }
+
+          ListItem {
+              anchors.left: parent.left
+              anchors.right: parent.right
+              height: l6.height + (divider.visible ? divider.height : 0)
+
+              SlotsLayout {
+                 id: l6
+                 mainSlot: Column {
+                    Text {
+                       text: i18n.tr("Image cache size")
+                       color: Theme.palette.normal.baseText
+                    }
+                    Slider {
+                       id: imageCacheSlider
+                       anchors.left: parent.left
+                       anchors.right: parent.right
+                       anchors.rightMargin: units.gu(1)
+
+                       function formatValue(v) { return null }
+
+                       minimumValue: 16.0
+                       maximumValue: 256.0
+                       stepSize: 16.0
+                       value: settingsPage.appSettings.imageCacheSize
+                       live: false
+
+                       onValueChanged: settingsPage.appSettings.imageCacheSize = value
+                    }
+                    Text {
+                       text: i18n.tr("%1 MB").arg(imageCacheSlider.value.toFixed(0))
+                       color: Theme.palette.normal.baseText
+                    }
+                    Text {
+                       text: i18n.tr("%1 MB in use, %2% hit rate")
+                       .arg(((settingsPage.cacheStats.bytesInUse || 0) / (1024 * 1024)).toFixed(1))
+                       .arg(((settingsPage.cacheStats.hitRate || 0) * 100).toFixed(0))
+                       color: Theme.palette.normal.baseText
+                    }
+                 }
+              }
+          }
        }
     }
 }
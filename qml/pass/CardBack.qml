@@ -46,6 +46,7 @@ Rectangle {
          anchors.leftMargin: units.gu(1.1)
          anchors.verticalCenter: parent.verticalCenter
          height: units.gu(6)
+         sourceSize.height: height
          fillMode: Image.PreserveAspectFit
          source: "image://passes/" + passCard.pass.id + "/logo"
          visible: !logoText.text
@@ -63,10 +64,10 @@ Rectangle {
       spacing: units.gu(1.5)
 
       Repeater {
-         model: passCard.pass.details.headerFields.reverse()
+         model: passCard.pass.headerFields
 
          delegate: PassHeaderField {
-            field: modelData
+            field: model
             foregroundColor: passCard.foregroundColor
             labelColor: passCard.labelColor
          }
@@ -92,14 +93,14 @@ Rectangle {
          spacing: units.gu(3)
          width: parent.width
          Repeater {
-            model: passCard.pass.details.backFields
+            model: passCard.pass.backFields
 
             delegate: Column {
                width: parent.width
 
                Text {
                   anchors.left: parent.left
-                  text: modelData.label.toUpperCase()
+                  text: model.label.toUpperCase()
                   font.pointSize: units.gu(1)
                   font.bold: true
                   color: labelColor
@@ -107,7 +108,7 @@ Rectangle {
 
                Text {
                   anchors.left: parent.left
-                  text: modelData.value
+                  text: model.value
                   font.pointSize: units.gu(1.5)
                   color: foregroundColor
                   wrapMode: Text.WordWrap
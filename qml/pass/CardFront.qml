@@ -20,6 +20,9 @@ Rectangle {
    property double stripWidth: 750.0 * stripSizeFactor
    property double stripHeight: 196.0 * stripSizeFactor
 
+   // collapsed cards in the list only show pre-scaled copies of the pass images
+   property string imageSuffix: selected ? "" : "/card"
+
    radius: units.gu(4)
    signal infoButtonPressed()
    signal cardClicked()
@@ -28,6 +31,23 @@ Rectangle {
    border.width: 1
    border.color: Qt.rgba(backgroundColor.r * 0.6, backgroundColor.g * 0.6, backgroundColor.b * 0.6, backgroundColor.a * 0.6)
 
+   // blurred background image (event tickets without strip image only). the image comes
+   // pre-blurred from the image provider, with the cards rounded corners already cut out
+
+   Image {
+      id: backgroundImage
+      anchors.fill: parent
+      anchors.margins: 1
+      visible: passCard.pass.details.style === "eventTicket"
+               && passCard.pass.haveBackgroundImage
+               && !passCard.pass.haveStripImage
+      source: visible ? "image://passes/" + passCard.pass.id + "/background/blurred/"
+                        + Math.round(passCard.radius * Screen.devicePixelRatio) : ""
+      sourceSize.width: width
+      sourceSize.height: height
+      smooth: true
+   }
+
    // header line (Logo text + Header fields)
 
    Rectangle {
@@ -51,8 +71,9 @@ Rectangle {
          Image {
             anchors.verticalCenter: parent.verticalCenter
             height: units.gu(6)
+            sourceSize.height: height
             fillMode: Image.PreserveAspectFit
-            source: "image://passes/" + passCard.pass.id + "/logo"
+            source: "image://passes/" + passCard.pass.id + "/logo" + passCard.imageSuffix
          }
 
          Text {
@@ -79,10 +100,10 @@ Rectangle {
       spacing: units.gu(1.5)
 
       Repeater {
-         model: passCard.pass.details.headerFields.reverse()
+         model: passCard.pass.headerFields
 
          delegate: PassHeaderField {
-            field: modelData
+            field: model
             foregroundColor: passCard.foregroundColor
             labelColor: passCard.labelColor
          }
@@ -107,8 +128,9 @@ Rectangle {
       anchors.rightMargin: units.gu(1)
 
       passId: passCard.pass.id
+      imageSuffix: passCard.imageSuffix
       style: passCard.pass.details.style
-      primaryFields: passCard.pass.details.primaryFields
+      primaryFields: passCard.pass.primaryFields
       foregroundColor: passCard.pass.standard.stripExtraForegroundColor || passCard.foregroundColor
       labelColor: passCard.pass.standard.stripExtraLabelColor || passCard.labelColor
 
@@ -131,14 +153,15 @@ Rectangle {
       clip: true
 
       Image {
-         property double factor: stripWidth / sourceSize.width
+         property double factor: implicitWidth > 0 ? stripWidth / implicitWidth : 0
 
          anchors.centerIn: parent
          width: stripWidth
-         height: sourceSize.height * factor
+         height: implicitHeight * factor
+         sourceSize.width: stripWidth
 
          fillMode: Image.PreserveAspectFit
-         source: "image://passes/" + passCard.pass.id + "/strip"
+         source: "image://passes/" + passCard.pass.id + "/strip" + passCard.imageSuffix
       }
    }
 
@@ -203,11 +226,11 @@ Rectangle {
             // secondary fields
 
             Repeater {
-               model: passCard.pass.details.secondaryFields
+               model: passCard.pass.secondaryFields
 
                delegate: PassField {
                   Layout.fillWidth: true
-                  field: modelData
+                  field: model
                   width: grid.numCols == 2 ? grid.colWidth2 : grid.colWidth3
                   foregroundColor: passCard.foregroundColor
                   labelColor: passCard.labelColor
@@ -217,11 +240,11 @@ Rectangle {
             // auxiliary fields
 
             Repeater {
-               model: passCard.pass.details.auxiliaryFields
+               model: passCard.pass.auxiliaryFields
 
                delegate: PassField {
                   Layout.fillWidth: true
-                  field: modelData
+                  field: model
                   width: grid.numCols == 2 ? grid.colWidth2 : grid.colWidth3
                   foregroundColor: passCard.foregroundColor
                   labelColor: passCard.labelColor
@@ -339,6 +362,8 @@ Rectangle {
       anchors.leftMargin: units.gu(2)
       anchors.bottom: parent.bottom
       anchors.bottomMargin: units.gu(2)
-      source: "image://passes/" + passCard.pass.id + "/icon"
+      sourceSize.width: width
+      sourceSize.height: height
+      source: "image://passes/" + passCard.pass.id + "/icon" + passCard.imageSuffix
    }
 }
@@ -7,7 +7,7 @@ Item {
    property var pass
    property double cardHeight: height*0.85
    property double cardWidth: width*0.85
-   property var theModel: pass ? (pass.bundlePasses.length ? pass.bundlePasses : [ pass ]) : []
+   property var theModel: pass ? (pass.bundlePasses.count ? pass.bundlePasses : [ pass ]) : []
 
    ListView {
       id: listView
@@ -20,7 +20,7 @@ Item {
       orientation: ListView.Horizontal
       highlightRangeMode: ListView.StrictlyEnforceRange
       model: theModel
-      interactive: theModel ? theModel.length > 1 : false
+      interactive: listView.count > 1
 
       delegate: Item {
          height: view.cardHeight
@@ -32,7 +32,7 @@ Item {
             anchors.centerIn: parent
             width: view.cardWidth
             height: view.cardHeight
-            pass: listView.model[index]
+            pass: modelData
             selected: true
          }
       }
@@ -43,7 +43,7 @@ Item {
       anchors.top: listView.bottom
       anchors.topMargin: units.gu(2)
       anchors.horizontalCenter: parent.horizontalCenter
-      visible: theModel ? theModel.length > 1 : false
+      visible: listView.count > 1
 
       currentIndex: listView.currentIndex
       count: listView.count
@@ -4,24 +4,31 @@ import QtGraphicalEffects 1.0
 Item {
    id: fields
    property string passId
+   property string imageSuffix: ""
    property string style: "generic"
    property string thumbnail: ""
-   property var primaryFields: []
+   property var primaryFields: null
+   property int fieldCount: primaryFields ? primaryFields.count : 0
    property color foregroundColor
    property color labelColor
 
    height: f.height
 
+   // reading count makes bindings re-evaluate whenever the fields change
+   function field(index) {
+      return primaryFields && index < primaryFields.count ? primaryFields.get(index) : {}
+   }
+
    Column {
       id: f
       anchors.left: parent.left
-      width: fields.primaryFields.length === 1 ? parent.width : parent.width / 2
+      width: fields.fieldCount === 1 ? parent.width : parent.width / 2
       height: childrenRect.height
 
       Text {
          width: parent.width
-         visible: fields.primaryFields.length
-         text: (fields.primaryFields.length && primaryFields[0].label || "").toUpperCase()
+         visible: fields.fieldCount
+         text: (fields.field(0).label || "").toUpperCase()
          wrapMode: Text.WordWrap
          font.pointSize: units.gu(1)
          font.bold: true
@@ -30,10 +37,10 @@ Item {
 
       Text {
          width: parent.width
-         visible: fields.primaryFields.length
-         text: fields.primaryFields.length && primaryFields[0].value || ""
+         visible: fields.fieldCount
+         text: fields.field(0).value || ""
          wrapMode: Text.WordWrap
-         font.pointSize: fields.primaryFields.length === 1 ? units.gu(1.5) : units.gu(2)
+         font.pointSize: fields.fieldCount === 1 ? units.gu(1.5) : units.gu(2)
          color: foregroundColor
       }
    }
@@ -58,21 +65,23 @@ Item {
       anchors.right: parent.right
       width: Math.max(f.height, units.gu(5))
       height: Math.max(f.height, units.gu(5))
-      source: "image://passes/" + passId + "/thumbnail"
-      visible: fields.style !== "boardingPass" && fields.primaryFields.length < 2
+      sourceSize.width: width
+      sourceSize.height: height
+      source: "image://passes/" + passId + "/thumbnail" + imageSuffix
+      visible: fields.style !== "boardingPass" && fields.fieldCount < 2
    }
 
    Column {
-      visible: fields.primaryFields.length === 2
+      visible: fields.fieldCount === 2
       anchors.right: parent.right
-      width: fields.primaryFields.length === 1 ? parent.width : parent.width / 2
+      width: fields.fieldCount === 1 ? parent.width : parent.width / 2
 
       height: childrenRect.height
 
       Text {
          width: parent.width
-         visible: fields.primaryFields.length >= 2
-         text: (fields.primaryFields.length >= 2 && primaryFields[1].label || "").toUpperCase()
+         visible: fields.fieldCount >= 2
+         text: (fields.field(1).label || "").toUpperCase()
          horizontalAlignment: Text.AlignRight
          wrapMode: Text.WordWrap
          font.pointSize: units.gu(1)
@@ -82,8 +91,8 @@ Item {
 
       Text {
          width: parent.width
-         visible: fields.primaryFields.length >= 2
-         text: fields.primaryFields.length >= 2 && primaryFields[1].value || ""
+         visible: fields.fieldCount >= 2
+         text: fields.field(1).value || ""
          horizontalAlignment: Text.AlignRight
          wrapMode: Text.WordWrap
          font.pointSize: units.gu(2)
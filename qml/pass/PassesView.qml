@@ -5,13 +5,24 @@ Rectangle {
    id: view
    property var model
    property var selectedPass
-   property var cards: []
    property double cardHeight: height*0.85
    property double cardWidth: width*0.85
    property double topMargin: (height-cardHeight)/2
    property double cardPeekHeight: units.gu(8)
    property bool showExpiredPasses: false
    property bool showActivity: false
+   property int count: view.model.visiblePasses.count
+   property bool searching: false
+   property bool nearby: false
+
+   onNearbyChanged: view.model.visiblePasses.nearby = nearby
+
+   onSearchingChanged: {
+      if (!searching)
+         searchField.text = ""
+      else
+         searchField.forceActiveFocus()
+   }
 
    color: "#efefef"
 
@@ -32,12 +43,6 @@ Rectangle {
       }
    ]
 
-   Connections {
-      target: model
-      onModelAboutToBeReset: cards = []
-      onRowsAboutToBeRemoved: cards.splice(first, 1)
-   }
-
    Rectangle {
       anchors.top: parent.top
       anchors.left: parent.left
@@ -62,10 +67,21 @@ Rectangle {
          }
       }
 
+      TextField {
+         id: searchField
+         anchors.verticalCenter: parent.verticalCenter
+         anchors.horizontalCenter: parent.horizontalCenter
+         width: view.cardWidth * 0.7
+         visible: view.searching && !view.selectedPass
+         placeholderText: i18n.tr("Search passes")
+         inputMethodHints: Qt.ImhNoPredictiveText
+         onTextChanged: view.model.visiblePasses.searchText = text
+      }
+
       Button {
          anchors.verticalCenter: parent.verticalCenter
          anchors.horizontalCenter: parent.horizontalCenter
-         visible: model.countExpired > 0 && !view.selectedPass
+         visible: model.countExpired > 0 && !view.selectedPass && !view.searching
          text: view.showExpiredPasses
                ? model.countExpired > 1 ? i18n.tr("Hide %1 expired passes").arg(model.countExpired) : i18n.tr("Hide %1 expired pass").arg(model.countExpired)
                : model.countExpired > 1 ? i18n.tr("Show %1 expired passes").arg(model.countExpired) : i18n.tr("Show %1 expired pass").arg(model.countExpired)
@@ -80,13 +96,6 @@ Rectangle {
       }
    }
 
-   Connections {
-      target: model
-      onCountChanged: {
-         flickable.contentHeight = (view.cards.length-1) * cardPeekHeight + view.cardHeight + topMargin
-      }
-   }
-
    PassDetailView {
       id: detailView
       visible: !!view.selectedPass
@@ -101,32 +110,83 @@ Rectangle {
       id: flickable
       anchors.fill: parent
       anchors.topMargin: view.topMargin
-      contentHeight: view.cardHeight
+      contentHeight: upNext.height + Math.max(repeater.count - 1, 0) * view.cardPeekHeight + view.cardHeight + view.topMargin
       contentWidth: parent.width
       visible: !view.selectedPass
 
+      Column {
+         id: upNext
+         anchors.horizontalCenter: parent.horizontalCenter
+         width: view.cardWidth
+         spacing: units.gu(1)
+         visible: upNextRepeater.count > 0 && !view.searching && !view.nearby
+         height: visible ? implicitHeight + units.gu(2) : 0
+
+         Text {
+            text: i18n.tr("Up next")
+            font.bold: true
+         }
+
+         Repeater {
+            id: upNextRepeater
+            model: view.model.upNext
+
+            Rectangle {
+               property var displayPass: model.pass.bundlePasses.count ? model.pass.bundlePasses.get(0) : model.pass
+
+               width: parent.width
+               height: units.gu(6)
+               radius: units.gu(1)
+               color: displayPass.standard.backgroundColor || "white"
+
+               Column {
+                  anchors.verticalCenter: parent.verticalCenter
+                  anchors.left: parent.left
+                  anchors.right: parent.right
+                  anchors.leftMargin: units.gu(2)
+                  anchors.rightMargin: units.gu(2)
+
+                  Text {
+                     width: parent.width
+                     elide: Text.ElideRight
+                     color: displayPass.standard.foregroundColor || "black"
+                     text: displayPass.standard.organization
+                  }
+
+                  Text {
+                     width: parent.width
+                     elide: Text.ElideRight
+                     color: displayPass.standard.labelColor || "gray"
+                     font.pointSize: units.gu(1)
+                     text: model.relevantDate.toLocaleString(Qt.locale(), Locale.ShortFormat)
+                  }
+               }
+
+               MouseArea {
+                  anchors.fill: parent
+                  onClicked: showCard(-1, model.pass)
+               }
+            }
+         }
+      }
+
       Repeater {
          id: repeater
-         model: view.model
+         model: view.model.visiblePasses
 
          Card {
             id: card
-            property int index
 
             width: view.cardWidth
             height: view.cardHeight
             anchors.horizontalCenter: parent.horizontalCenter
             anchors.top: parent.top
-            anchors.topMargin: index*view.cardPeekHeight
+            anchors.topMargin: upNext.height + index*view.cardPeekHeight
+            z: index
 
-            pass: modelData.bundlePasses.length ? modelData.bundlePasses[0] : modelData
-
-            onCardFrontClicked: showCard(index, modelData)
-         }
+            pass: model.bundleCount ? model.bundlePasses.get(0) : model.pass
 
-         onItemAdded: {
-            item.index = index
-            cards.push(item)
+            onCardFrontClicked: showCard(index, model.pass)
          }
       }
    }
@@ -20,20 +20,17 @@
 // **************************************************************************
 
 #include <QDebug>
+#include <stdexcept>
+#include <string>
 
 #include "barcode.h"
 
-#include "ZXing/MultiFormatWriter.h"
 #include "ZXing/BarcodeFormat.h"
 #include "ZXing/BitMatrix.h"
 #include "ZXing/ByteMatrix.h"
 #include "ZXing/MultiFormatWriter.h"
-#include "ZXing/TextUtfEncoding.h"
 #include "ZXing/CharacterSetECI.h"
 
-#define STB_IMAGE_WRITE_IMPLEMENTATION
-#include "thirdparty/stb_image_write.h"
-
 namespace C {
 #include <libintl.h>
 }
@@ -41,61 +38,169 @@ namespace C {
 namespace passes
 {
    // **************************************************************************
-   // class BarcodeGenerator
+   // characterSet
    // **************************************************************************
 
-   QString BarcodeGenerator::generate(QString text, QString fmt, QImage* dest)
+   static ZXing::CharacterSet characterSet(const QString& encoding)
    {
-      using namespace ZXing;
+      // PassKit passes usually specify iso-8859-1. Without a (known) encoding given, leave the
+      // choice to zxing as before, so existing passes render the same symbols without an ECI.
 
-      int width = 500, height = 500;
-      int margin = 5;
-      int eccLevel = -1;
-      CharacterSet encoding = CharacterSet::UTF8;
-      BarcodeFormat format;
+      if (!encoding.compare(QLatin1String("iso-8859-1"), Qt::CaseInsensitive)
+          || !encoding.compare(QLatin1String("latin1"), Qt::CaseInsensitive))
+         return ZXing::CharacterSet::ISO8859_1;
+
+      if (!encoding.compare(QLatin1String("utf-8"), Qt::CaseInsensitive)
+          || !encoding.compare(QLatin1String("utf8"), Qt::CaseInsensitive))
+         return ZXing::CharacterSet::UTF8;
+
+      return ZXing::CharacterSet::Unknown;
+   }
+
+   // **************************************************************************
+   // toCodePoints
+   // **************************************************************************
+
+   // fills the (reused) buffer with one code point per character of the message, without the
+   // intermediate UTF-8 byte array and its decoding. for ISO-8859-1 every code point is a single
+   // byte, so zxing's byte mode writes the original latin1 bytes unchanged.
+
+   static bool toCodePoints(const QString& text, ZXing::CharacterSet encoding, std::wstring& dest)
+   {
+      const QChar* it = text.constData();
+      const QChar* end = it + text.size();
+
+      dest.clear();
+      dest.reserve(text.size());
+
+      if (encoding == ZXing::CharacterSet::ISO8859_1)
+      {
+         for (; it != end; ++it)
+         {
+            if (it->unicode() > 0xFF)
+               return false;
+
+            dest.push_back(static_cast<wchar_t>(it->unicode()));
+         }
+
+         return true;
+      }
+
+      for (; it != end; ++it)
+      {
+         if (it->isHighSurrogate() && it + 1 != end && (it + 1)->isLowSurrogate())
+         {
+            dest.push_back(static_cast<wchar_t>(QChar::surrogateToUcs4(*it, *(it + 1))));
+            ++it;
+         }
+         else
+            dest.push_back(static_cast<wchar_t>(it->unicode()));
+      }
+
+      return true;
+   }
+
+   // **************************************************************************
+   // barcodeFormat
+   // **************************************************************************
+
+   static bool barcodeFormat(const QString& fmt, ZXing::BarcodeFormat* format)
+   {
+      using namespace ZXing;
 
       if (fmt == "PKBarcodeFormatPDF417")
-         format = BarcodeFormat::PDF_417;
+         *format = BarcodeFormat::PDF_417;
       else if (fmt == "PKBarcodeFormatAztec")
-         format = BarcodeFormat::AZTEC;
+         *format = BarcodeFormat::AZTEC;
       else if (fmt == "PKBarcodeFormatQR")
-         format = BarcodeFormat::QR_CODE;
+         *format = BarcodeFormat::QR_CODE;
       else if (fmt == "PKBarcodeFormatCode128")
-         format = BarcodeFormat::CODE_128;
+         *format = BarcodeFormat::CODE_128;
       else if (fmt == "CODE_39")
-         format = BarcodeFormat::CODE_39;
+         *format = BarcodeFormat::CODE_39;
       else if (fmt == "EAN-8")
-         format = BarcodeFormat::EAN_8;
+         *format = BarcodeFormat::EAN_8;
       else if (fmt == "EAN-13")
-         format = BarcodeFormat::EAN_13;
+         *format = BarcodeFormat::EAN_13;
       else if (fmt == "UPC-A")
-         format = BarcodeFormat::UPC_A;
+         *format = BarcodeFormat::UPC_A;
       else
+         return false;
+
+      return true;
+   }
+
+   // **************************************************************************
+   // class BarcodeGenerator
+   // **************************************************************************
+
+   QString BarcodeGenerator::validate(const QString& fmt)
+   {
+      ZXing::BarcodeFormat format;
+
+      if (!barcodeFormat(fmt, &format))
          return QString(C::gettext("Unknown barcode format")) + " (" + fmt + ")";
 
+      return "";
+   }
+
+   QString BarcodeGenerator::generate(const QString& text, const QString& fmt, const QString& encodingName, QImage* dest)
+   {
+      using namespace ZXing;
+
+      // keep each threads conversion buffer around instead of allocating a fresh wide string
+      // for every (possibly large PDF417) barcode
+
+      static thread_local std::wstring contents;
+
+      int width = 500, height = 500;
+      int margin = 5;
+      int eccLevel = -1;
+      CharacterSet encoding = characterSet(encodingName);
+      BarcodeFormat format;
+
+      if (!barcodeFormat(fmt, &format))
+         return QString(C::gettext("Unknown barcode format")) + " (" + fmt + ")";
+
+      if (!toCodePoints(text, encoding, contents))
+      {
+         // message contains characters outside of latin1, the declared encoding is wrong.
+         // leave the encoding to zxing rather than dropping characters.
+
+         qDebug() << "Barcode message not representable in" << encodingName;
+
+         encoding = CharacterSet::Unknown;
+         toCodePoints(text, encoding, contents);
+      }
+
+      // only a declared encoding is passed on, zxing's default stays untouched otherwise
+
       MultiFormatWriter writer(format);
+
+      if (encoding != CharacterSet::Unknown)
+         writer.setEncoding(encoding);
+
       if (margin >= 0)
          writer.setMargin(margin);
       if (eccLevel >= 0)
          writer.setEccLevel(eccLevel);
 
-      auto bitmap = writer.encode(TextUtfEncoding::FromUtf8(text.toUtf8().constData()), width, height).toByteMatrix();
+      try
+      {
+         auto bitmap = writer.encode(contents, width, height).toByteMatrix();
 
-      QByteArray dataArray;
+         // the byte matrix already holds 8 bit grayscale pixels (0 = black, 255 = white), so wrap
+         // it directly instead of encoding to PNG and decoding again
 
-      int res = stbi_write_png_to_func(&BarcodeGenerator::stbiWriteFunc, &dataArray, bitmap.width(), bitmap.height(), 1, bitmap.data(), 0);
+         *dest = QImage(reinterpret_cast<const uchar*>(bitmap.data()), bitmap.width(), bitmap.height(),
+                        bitmap.width(), QImage::Format_Grayscale8).copy();
+      }
+      catch (const std::exception& e)
+      {
+         // e.g. letters in an EAN message
+         return QString(C::gettext("Barcode could not be generated")) + " (" + e.what() + ")";
+      }
 
-      dest->loadFromData(dataArray);
       return "";
    }
-
-   void BarcodeGenerator::stbiWriteFunc(void* context, void* data, int size)
-   {
-      QByteArray* dataArray = (QByteArray*)context;
-
-      if (!dataArray)
-         return;
-
-      dataArray->append((const char*)data, size);
-   }
 }
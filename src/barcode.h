@@ -34,10 +34,8 @@ namespace passes
    class BarcodeGenerator
    {
       public:
-         static QString generate(QString text, QString format, QImage* dest);
-
-      private:
-         static void stbiWriteFunc(void* context, void* data, int size);
+         static QString validate(const QString& format);
+         static QString generate(const QString& text, const QString& format, const QString& encoding, QImage* dest);
    };
 } // namespace passes
 
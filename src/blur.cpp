@@ -0,0 +1,201 @@
+// **************************************************************************
+// namespace blur
+// 19.10.2026
+// Blurred, downscaled pass background images
+// **************************************************************************
+// MIT License
+// Copyright © 2021 Patrick Fial
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions: The above copyright notice and this
+// permission notice shall be included in all copies or substantial portions of the Software. THE
+// SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+// LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// **************************************************************************
+// includes
+// **************************************************************************
+
+#include "blur.h"
+#include "imagecache.h"
+
+#include <QPainter>
+#include <vector>
+
+namespace passes {
+namespace blur {
+// all four channels of a pixel are processed at once. the vector extension maps to SSE2 on x86
+// and NEON on ARM, and to plain scalar code everywhere else.
+
+typedef quint32 Pixel __attribute__((vector_size(16)));
+
+// width of the blurred image, it is upscaled (and thereby smoothed further) when displayed
+
+static const int blurWidth = 90;
+static const int blurRadius = 4;
+
+// **************************************************************************
+// blurRowsTransposed
+// **************************************************************************
+
+// box blurs every row of src (width x height) and writes the result transposed into dst
+// (height x width). running it twice blurs rows and columns while keeping memory access linear.
+
+static void blurRowsTransposed(const Pixel* src, Pixel* dst, int width, int height, int radius)
+{
+    const int window = 2 * radius + 1;
+    const quint32 mul = (1u << 24) / window; // sum * mul never exceeds 255 << 24
+    const Pixel scale = {mul, mul, mul, mul};
+    const Pixel round = {1u << 23, 1u << 23, 1u << 23, 1u << 23};
+
+    for (int y = 0; y < height; y++) {
+        const Pixel* row = src + y * width;
+        Pixel sum = row[0] * (quint32)(radius + 1);
+
+        for (int x = 1; x <= radius; x++)
+            sum += row[x < width ? x : width - 1];
+
+        for (int x = 0; x < width; x++) {
+            dst[x * height + y] = (sum * scale + round) >> 24;
+
+            int add = x + radius + 1;
+            int sub = x - radius;
+
+            sum += row[add < width ? add : width - 1];
+            sum -= row[sub > 0 ? sub : 0];
+        }
+    }
+}
+
+// **************************************************************************
+// boxBlur
+// **************************************************************************
+
+void boxBlur(uchar* bits, int width, int height, int bytesPerLine, int radius, int iterations)
+{
+    if (width <= 0 || height <= 0 || radius <= 0)
+        return;
+
+    std::vector<Pixel> a(width * height), b(width * height);
+
+    // unpack ARGB32 (premultiplied) into one lane per channel
+
+    for (int y = 0; y < height; y++) {
+        const quint32* line = reinterpret_cast<const quint32*>(bits + y * bytesPerLine);
+
+        for (int x = 0; x < width; x++) {
+            quint32 p = line[x];
+            a[y * width + x] = Pixel {p & 0xff, (p >> 8) & 0xff, (p >> 16) & 0xff, p >> 24};
+        }
+    }
+
+    // three box passes approximate a gaussian
+
+    for (int i = 0; i < iterations; i++) {
+        blurRowsTransposed(a.data(), b.data(), width, height, radius);
+        blurRowsTransposed(b.data(), a.data(), height, width, radius);
+    }
+
+    for (int y = 0; y < height; y++) {
+        quint32* line = reinterpret_cast<quint32*>(bits + y * bytesPerLine);
+
+        for (int x = 0; x < width; x++) {
+            const Pixel& p = a[y * width + x];
+            line[x] = p[0] | (p[1] << 8) | (p[2] << 16) | (p[3] << 24);
+        }
+    }
+}
+
+// **************************************************************************
+// blurred
+// **************************************************************************
+
+// the small blurred copy of an image, shared by all sizes it is shown at
+
+static QImage blurred(const ImageHandle& image)
+{
+    QByteArray key = "blurred/" + image->hash;
+    QImage result = ImageCache::instance()->find(key);
+
+    if (!result.isNull())
+        return result;
+
+    // blur a small copy only, nobody can tell the difference once it is blurred anyway
+
+    QSize scaledSize = image->size;
+
+    if (scaledSize.width() > blurWidth)
+        scaledSize = QSize(blurWidth, qMax(1, image->size.height() * blurWidth / image->size.width()));
+
+    result = ImageStore::instance()
+               ->read(image, scaledSize)
+               .convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+    if (result.isNull())
+        return result;
+
+    boxBlur(result.bits(), result.width(), result.height(), result.bytesPerLine(), blurRadius, 3);
+
+    ImageCache::instance()->insert(key, result);
+
+    return result;
+}
+
+// **************************************************************************
+// blurredBackground
+// **************************************************************************
+
+// the blurred image cropped to size and with the cards rounded corners cut out, so it can be
+// drawn as is instead of being masked in an offscreen layer per card
+
+QImage blurredBackground(const ImageHandle& image, const QSize& size, int cornerRadius)
+{
+    if (!image || image->size.isEmpty())
+        return QImage();
+
+    QImage source = blurred(image);
+
+    if (source.isNull() || ((!size.isValid() || size == source.size()) && cornerRadius <= 0))
+        return source;
+
+    QSize targetSize = size.isValid() && !size.isEmpty() ? size : source.size();
+    QByteArray key = "blurred/" + image->hash + "/" + QByteArray::number(targetSize.width()) + "x"
+                     + QByteArray::number(targetSize.height()) + "/"
+                     + QByteArray::number(cornerRadius);
+    QImage result = ImageCache::instance()->find(key);
+
+    if (!result.isNull())
+        return result;
+
+    // crop to the targets aspect ratio first, like Image.PreserveAspectCrop would
+
+    QSize cropSize = targetSize.scaled(source.size(), Qt::KeepAspectRatio);
+    QRect crop(QPoint((source.width() - cropSize.width()) / 2,
+                      (source.height() - cropSize.height()) / 2),
+               cropSize);
+
+    QImage scaled =
+      source.copy(crop).scaled(targetSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+
+    result = QImage(targetSize, QImage::Format_ARGB32_Premultiplied);
+    result.fill(Qt::transparent);
+
+    QPainter painter(&result);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(scaled);
+    painter.drawRoundedRect(result.rect(), cornerRadius, cornerRadius);
+    painter.end();
+
+    ImageCache::instance()->insert(key, result);
+
+    return result;
+}
+
+} // namespace blur
+} // namespace passes
@@ -0,0 +1,42 @@
+// **************************************************************************
+// namespace blur
+// 19.10.2026
+// Blurred, downscaled pass background images
+// **************************************************************************
+// MIT License
+// Copyright © 2021 Patrick Fial
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions: The above copyright notice and this
+// permission notice shall be included in all copies or substantial portions of the Software. THE
+// SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+// LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// **************************************************************************
+// includes
+// **************************************************************************
+
+#ifndef BLUR_H
+#define BLUR_H
+
+#include <QImage>
+
+#include "imagestore.h"
+
+// **************************************************************************
+// namespace blur
+// **************************************************************************
+
+namespace passes {
+namespace blur {
+void boxBlur(uchar* bits, int width, int height, int bytesPerLine, int radius, int iterations);
+QImage blurredBackground(const ImageHandle& image, const QSize& size, int cornerRadius);
+} // namespace blur
+} // namespace passes
+
+#endif // BLUR_H
@@ -0,0 +1,184 @@
+// **************************************************************************
+// namespace colors
+// 19.10.2026
+// Luminance helpers for pass colors and images
+// **************************************************************************
+// MIT License
+// Copyright © 2021 Patrick Fial
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions: The above copyright notice and this
+// permission notice shall be included in all copies or substantial portions of the Software. THE
+// SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+// LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// **************************************************************************
+// includes
+// **************************************************************************
+
+#include "colors.h"
+
+#include <QCache>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <array>
+#include <cmath>
+
+namespace passes {
+namespace colors {
+// luminosity calculation as per
+// https://stackoverflow.com/questions/596216/formula-to-determine-perceived-brightness-of-rgb-color
+
+static const int sampleWidth = 128;
+static const int histogramBins = 256;
+static const int cacheEntries = 512;
+
+// **************************************************************************
+// luminance tables
+// **************************************************************************
+
+// sRGB -> linear for every 8 bit channel value, weighted per channel and stored as fixed point
+// (white sums up to 255 << 8) so that the luminance of a pixel is three lookups and two additions
+
+struct Tables {
+    std::array<double, 256> linear;
+    std::array<quint32, 256> red, green, blue;
+
+    Tables()
+    {
+        for (int i = 0; i < 256; i++) {
+            double c = i / 255.0;
+
+            linear[i] = c <= 0.04045 ? c / 12.92 : pow((c + 0.055) / 1.055, 2.4);
+            red[i] = qRound(0.2126 * linear[i] * (255 << 8));
+            green[i] = qRound(0.7152 * linear[i] * (255 << 8));
+            blue[i] = qRound(0.0722 * linear[i] * (255 << 8));
+        }
+    }
+};
+
+static const Tables& tables()
+{
+    static const Tables t;
+    return t;
+}
+
+// **************************************************************************
+// sRGBtoLin
+// **************************************************************************
+
+double sRGBtoLin(int colorChannel)
+{
+    return tables().linear[qBound(0, colorChannel, 255)];
+}
+
+// **************************************************************************
+// getLuminance
+// **************************************************************************
+
+double getLuminance(const QColor& color)
+{
+    return (0.2126 * sRGBtoLin(color.red()) + 0.7152 * sRGBtoLin(color.green())
+            + 0.0722 * sRGBtoLin(color.blue()));
+}
+
+// **************************************************************************
+// histogram
+// **************************************************************************
+
+// adds the luminance of every pixel of one scanline to the histogram
+
+static void addToHistogram(const quint32* line, int count, quint32* histogram)
+{
+    const Tables& t = tables();
+
+    for (int x = 0; x < count; x++) {
+        quint32 p = line[x];
+        histogram[(t.red[(p >> 16) & 0xff] + t.green[(p >> 8) & 0xff] + t.blue[p & 0xff]) >> 8]++;
+    }
+}
+
+// **************************************************************************
+// getImageLuminance
+// **************************************************************************
+
+// median luminance of a region (given relative to the image size) of an image, -1 if the image
+// cannot be decoded. the result only depends on the image data and is cached by image hash, for
+// the most recently used images only.
+
+double getImageLuminance(const ImageHandle& image, const QRectF& region)
+{
+    static QMutex mutex;
+    static QCache<QByteArray, double> cache(cacheEntries);
+
+    if (!image || image->size.isEmpty())
+        return -1.0;
+
+    QByteArray key = image->hash + "/" + QByteArray::number(region.x()) + ","
+                     + QByteArray::number(region.y()) + "," + QByteArray::number(region.width())
+                     + "," + QByteArray::number(region.height());
+
+    {
+        QMutexLocker lock(&mutex);
+
+        if (auto cached = cache.object(key))
+            return *cached;
+    }
+
+    // a downscaled copy is plenty for a histogram and much cheaper to decode
+
+    QSize scaledSize = image->size;
+
+    if (scaledSize.width() > sampleWidth)
+        scaledSize = QSize(sampleWidth, qMax(1, image->size.height() * sampleWidth / image->size.width()));
+
+    QImage decoded = ImageStore::instance()->read(image, scaledSize);
+
+    if (decoded.isNull())
+        return -1.0;
+
+    decoded = decoded.convertToFormat(QImage::Format_RGB32);
+
+    QRect area = QRect(qRound(region.x() * decoded.width()), qRound(region.y() * decoded.height()),
+                       qRound(region.width() * decoded.width()),
+                       qRound(region.height() * decoded.height()))
+                   .intersected(decoded.rect());
+
+    if (area.isEmpty())
+        area = decoded.rect();
+
+    std::array<quint32, histogramBins> histogram {};
+
+    for (int y = area.top(); y <= area.bottom(); y++) {
+        auto line = reinterpret_cast<const quint32*>(decoded.constScanLine(y)) + area.left();
+        addToHistogram(line, area.width(), histogram.data());
+    }
+
+    quint32 half = (area.width() * area.height() + 1) / 2, seen = 0;
+    int bin = 0;
+
+    for (; bin < histogramBins - 1; bin++) {
+        seen += histogram[bin];
+
+        if (seen >= half)
+            break;
+    }
+
+    // the center of the bin, the bins split 0..1 into histogramBins equal parts
+
+    double luminance = (bin + 0.5) / histogramBins;
+
+    QMutexLocker lock(&mutex);
+    cache.insert(key, new double(luminance));
+
+    return luminance;
+}
+
+} // namespace colors
+} // namespace passes
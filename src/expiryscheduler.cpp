@@ -0,0 +1,177 @@
+// **************************************************************************
+// class ExpiryScheduler
+// 19.10.2026
+// Single timer notifying about passes reaching their expiration date
+// **************************************************************************
+// MIT License
+// Copyright © 2021 Patrick Fial
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions: The above copyright notice and this
+// permission notice shall be included in all copies or substantial portions of the Software. THE
+// SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+// LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// **************************************************************************
+// includes
+// **************************************************************************
+
+#include "expiryscheduler.h"
+
+#include <QGuiApplication>
+
+namespace passes {
+// the timer never sleeps longer than this. it runs on a monotonic clock, so wall clock changes
+// (manual adjustments, NTP, suspend) are only noticed when it fires or the app becomes active.
+
+static const int maxInterval = 15 * 60 * 1000;
+
+// **************************************************************************
+// class ExpiryScheduler
+// **************************************************************************
+
+ExpiryScheduler::ExpiryScheduler(QObject* parent) : QObject(parent), nextGeneration(0)
+{
+    timer.setSingleShot(true);
+    timer.setTimerType(Qt::VeryCoarseTimer);
+
+    connect(&timer, &QTimer::timeout, this, &ExpiryScheduler::check);
+
+    if (auto app = qobject_cast<QGuiApplication*>(QCoreApplication::instance())) {
+        connect(app, &QGuiApplication::applicationStateChanged, this,
+                [this](Qt::ApplicationState state) {
+                    // deadlines in local time may have moved relative to each other if the
+                    // timezone changed in the meantime, so the heap is rebuilt as well
+
+                    if (state == Qt::ApplicationActive) {
+                        compact();
+                        check();
+                    }
+                });
+    }
+}
+
+// **************************************************************************
+// schedule
+// **************************************************************************
+
+void ExpiryScheduler::schedule(const QString& id, const QDateTime& deadline)
+{
+    if (!deadline.isValid())
+        return;
+
+    auto it = generations.find(id);
+
+    if (it == generations.end())
+        it = generations.insert(id, ++nextGeneration);
+
+    heap.push(Entry {deadline, id, *it});
+
+    arm();
+}
+
+// **************************************************************************
+// unschedule
+// **************************************************************************
+
+void ExpiryScheduler::unschedule(const QString& id)
+{
+    generations.remove(id);
+
+    if (heap.size() > 64 && heap.size() > 2 * (size_t)generations.size())
+        compact();
+}
+
+// **************************************************************************
+// clear
+// **************************************************************************
+
+void ExpiryScheduler::clear()
+{
+    heap = decltype(heap)();
+    generations.clear();
+    timer.stop();
+}
+
+// **************************************************************************
+// check
+// **************************************************************************
+
+void ExpiryScheduler::check()
+{
+    QDateTime now = QDateTime::currentDateTime();
+    QStringList due;
+
+    while (!heap.empty()) {
+        const Entry& top = heap.top();
+
+        if (!isStale(top) && top.deadline > now)
+            break;
+
+        if (!isStale(top) && !due.contains(top.id))
+            due << top.id;
+
+        heap.pop();
+    }
+
+    arm();
+
+    for (const auto& id : due)
+        emit expired(id);
+}
+
+// **************************************************************************
+// isStale
+// **************************************************************************
+
+bool ExpiryScheduler::isStale(const Entry& entry) const
+{
+    auto it = generations.constFind(entry.id);
+
+    return it == generations.constEnd() || *it != entry.generation;
+}
+
+// **************************************************************************
+// compact
+// **************************************************************************
+
+void ExpiryScheduler::compact()
+{
+    std::vector<Entry> entries;
+    entries.reserve(generations.size());
+
+    while (!heap.empty()) {
+        if (!isStale(heap.top()))
+            entries.push_back(heap.top());
+
+        heap.pop();
+    }
+
+    heap = decltype(heap)(Later(), std::move(entries));
+}
+
+// **************************************************************************
+// arm
+// **************************************************************************
+
+void ExpiryScheduler::arm()
+{
+    while (!heap.empty() && isStale(heap.top()))
+        heap.pop();
+
+    if (heap.empty()) {
+        timer.stop();
+        return;
+    }
+
+    qint64 msecs = QDateTime::currentDateTime().msecsTo(heap.top().deadline);
+
+    timer.start((int)qBound<qint64>(0, msecs, maxInterval));
+}
+
+} // namespace passes
@@ -0,0 +1,86 @@
+// **************************************************************************
+// class ExpiryScheduler
+// 19.10.2026
+// Single timer notifying about passes reaching their expiration date
+// **************************************************************************
+// MIT License
+// Copyright © 2021 Patrick Fial
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions: The above copyright notice and this
+// permission notice shall be included in all copies or substantial portions of the Software. THE
+// SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+// LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// **************************************************************************
+// includes
+// **************************************************************************
+
+#ifndef EXPIRYSCHEDULER_H
+#define EXPIRYSCHEDULER_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QObject>
+#include <QTimer>
+
+#include <queue>
+#include <vector>
+
+// **************************************************************************
+// class ExpiryScheduler
+// **************************************************************************
+
+// keeps the upcoming deadlines of all passes in a min-heap and arms one timer for the earliest.
+// unscheduled passes are not searched for in the heap, their entries are dropped when they
+// surface (lazy deletion).
+
+namespace passes {
+class ExpiryScheduler : public QObject {
+    Q_OBJECT
+
+public:
+    explicit ExpiryScheduler(QObject* parent = nullptr);
+
+    void schedule(const QString& id, const QDateTime& deadline);
+    void unschedule(const QString& id);
+    void clear();
+
+signals:
+    void expired(const QString& id);
+
+public slots:
+    void check();
+
+private:
+    struct Entry {
+        QDateTime deadline;
+        QString id;
+        quint64 generation;
+    };
+
+    struct Later {
+        bool operator()(const Entry& a, const Entry& b) const
+        {
+            return a.deadline > b.deadline;
+        }
+    };
+
+    bool isStale(const Entry& entry) const;
+    void compact();
+    void arm();
+
+    std::priority_queue<Entry, std::vector<Entry>, Later> heap;
+    QHash<QString, quint64> generations;
+    quint64 nextGeneration;
+    QTimer timer;
+};
+
+} // namespace passes
+
+#endif // EXPIRYSCHEDULER_H
@@ -0,0 +1,141 @@
+// **************************************************************************
+// class FieldsModel
+// 19.10.2026
+// List model over one field section of a pass
+// **************************************************************************
+// MIT License
+// Copyright © 2021 Patrick Fial
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions: The above copyright notice and this
+// permission notice shall be included in all copies or substantial portions of the Software. THE
+// SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+// LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// **************************************************************************
+// includes
+// **************************************************************************
+
+#include "fieldsmodel.h"
+
+#include <algorithm>
+
+namespace passes {
+// **************************************************************************
+// class FieldsModel
+// **************************************************************************
+
+FieldsModel::FieldsModel(bool reversed, QObject* parent)
+  : QAbstractListModel(parent), reversed(reversed)
+{}
+
+// **************************************************************************
+// data
+// **************************************************************************
+
+QVariant FieldsModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= mItems.size())
+        return QVariant();
+
+    const auto& field = mItems[index.row()];
+
+    switch (role) {
+        case KeyRole:
+            return field.key;
+        case Qt::DisplayRole:
+        case ValueRole:
+            return field.value;
+        case LabelRole:
+            return field.label;
+        default:
+            break;
+    }
+
+    return QVariant();
+}
+
+// **************************************************************************
+// rowCount
+// **************************************************************************
+
+int FieldsModel::rowCount(const QModelIndex& /*parent*/) const
+{
+    return mItems.size();
+}
+
+// **************************************************************************
+// roleNames
+// **************************************************************************
+
+QHash<int, QByteArray> FieldsModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[KeyRole] = "key";
+    roles[ValueRole] = "value";
+    roles[LabelRole] = "label";
+    return roles;
+}
+
+// **************************************************************************
+// get
+// **************************************************************************
+
+QVariant FieldsModel::get(int row) const
+{
+    if (row < 0 || row >= mItems.size())
+        return QVariant();
+
+    return QVariant::fromValue(mItems[row]);
+}
+
+// **************************************************************************
+// setFields
+// **************************************************************************
+
+// only notifies about what actually changed, so delegates of unchanged fields are left alone
+// when a pass update comes in
+
+void FieldsModel::setFields(QList<PassStyleField> fields)
+{
+    if (reversed)
+        std::reverse(fields.begin(), fields.end());
+
+    bool changed = false;
+    int common = qMin(mItems.size(), fields.size());
+
+    for (int i = 0; i < common; i++) {
+        const auto& from = mItems[i];
+        const auto& to = fields[i];
+
+        if (from.key == to.key && from.value == to.value && from.label == to.label)
+            continue;
+
+        mItems[i] = to;
+        changed = true;
+
+        emit dataChanged(index(i), index(i));
+    }
+
+    if (fields.size() > mItems.size()) {
+        beginInsertRows(QModelIndex(), mItems.size(), fields.size() - 1);
+        mItems.append(fields.mid(mItems.size()));
+        endInsertRows();
+        changed = true;
+    } else if (fields.size() < mItems.size()) {
+        beginRemoveRows(QModelIndex(), fields.size(), mItems.size() - 1);
+        mItems.erase(mItems.begin() + fields.size(), mItems.end());
+        endRemoveRows();
+        changed = true;
+    }
+
+    if (changed)
+        emit fieldsChanged();
+}
+
+} // namespace passes
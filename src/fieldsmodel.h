@@ -0,0 +1,67 @@
+// **************************************************************************
+// class FieldsModel
+// 19.10.2026
+// List model over one field section of a pass
+// **************************************************************************
+// MIT License
+// Copyright © 2021 Patrick Fial
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions: The above copyright notice and this
+// permission notice shall be included in all copies or substantial portions of the Software. THE
+// SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+// LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// **************************************************************************
+// includes
+// **************************************************************************
+
+#ifndef FIELDSMODEL_H
+#define FIELDSMODEL_H
+
+#include <QAbstractListModel>
+
+#include "pkpass.h"
+
+// **************************************************************************
+// class FieldsModel
+// **************************************************************************
+
+namespace passes {
+class FieldsModel : public QAbstractListModel {
+    enum RoleNames { KeyRole = Qt::UserRole + 1, ValueRole, LabelRole };
+
+    Q_OBJECT
+    Q_PROPERTY(int count READ rowCount NOTIFY fieldsChanged)
+
+public:
+    explicit FieldsModel(bool reversed, QObject* parent = nullptr);
+
+    // QAbstractListModel
+
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const;
+    QHash<int, QByteArray> roleNames() const;
+
+    // QML interaction
+
+    Q_INVOKABLE QVariant get(int row) const;
+
+    void setFields(QList<PassStyleField> fields);
+
+signals:
+    void fieldsChanged();
+
+private:
+    bool reversed;
+    QList<PassStyleField> mItems;
+};
+
+} // namespace passes
+
+#endif // FIELDSMODEL_H
@@ -0,0 +1,117 @@
+// **************************************************************************
+// class ImageCache
+// 19.10.2026
+// Memory bounded cache of decoded pass images
+// **************************************************************************
+// MIT License
+// Copyright © 2021 Patrick Fial
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions: The above copyright notice and this
+// permission notice shall be included in all copies or substantial portions of the Software. THE
+// SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+// LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// **************************************************************************
+// includes
+// **************************************************************************
+
+#include "imagecache.h"
+
+#include <climits>
+
+namespace passes {
+// **************************************************************************
+// class ImageCache
+// **************************************************************************
+
+ImageCache::ImageCache() : images(64 * 1024 * 1024), hits(0), misses(0) {}
+
+ImageCache* ImageCache::instance()
+{
+    static ImageCache cache;
+    return &cache;
+}
+
+// **************************************************************************
+// find
+// **************************************************************************
+
+QImage ImageCache::find(const QByteArray& key)
+{
+    QMutexLocker lock(&mutex);
+
+    QImage* image = images.object(key);
+
+    if (!image) {
+        misses++;
+        return QImage();
+    }
+
+    hits++;
+    return *image;
+}
+
+// **************************************************************************
+// insert
+// **************************************************************************
+
+void ImageCache::insert(const QByteArray& key, const QImage& image)
+{
+    if (image.isNull())
+        return;
+
+    QMutexLocker lock(&mutex);
+
+    // images larger than the whole budget are not kept at all (QCache deletes them right away)
+
+    images.insert(key, new QImage(image), image.bytesPerLine() * image.height());
+}
+
+// **************************************************************************
+// setBudget
+// **************************************************************************
+
+void ImageCache::setBudget(qint64 bytes)
+{
+    QMutexLocker lock(&mutex);
+    images.setMaxCost(static_cast<int>(qBound(qint64(0), bytes, qint64(INT_MAX))));
+}
+
+// **************************************************************************
+// getBudget
+// **************************************************************************
+
+qint64 ImageCache::getBudget()
+{
+    QMutexLocker lock(&mutex);
+    return images.maxCost();
+}
+
+// **************************************************************************
+// getStats
+// **************************************************************************
+
+QVariantMap ImageCache::getStats()
+{
+    QMutexLocker lock(&mutex);
+
+    quint64 lookups = hits + misses;
+
+    QVariantMap stats;
+    stats.insert("hits", hits);
+    stats.insert("misses", misses);
+    stats.insert("hitRate", lookups ? static_cast<double>(hits) / lookups : 0.0);
+    stats.insert("bytesInUse", images.totalCost());
+    stats.insert("budget", images.maxCost());
+    stats.insert("count", images.count());
+
+    return stats;
+}
+
+} // namespace passes
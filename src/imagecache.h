@@ -0,0 +1,60 @@
+// **************************************************************************
+// class ImageCache
+// 19.10.2026
+// Memory bounded cache of decoded pass images
+// **************************************************************************
+// MIT License
+// Copyright © 2021 Patrick Fial
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions: The above copyright notice and this
+// permission notice shall be included in all copies or substantial portions of the Software. THE
+// SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+// LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// **************************************************************************
+// includes
+// **************************************************************************
+
+#ifndef IMAGECACHE_H
+#define IMAGECACHE_H
+
+#include <QByteArray>
+#include <QCache>
+#include <QImage>
+#include <QMutex>
+#include <QVariantMap>
+
+// **************************************************************************
+// class ImageCache
+// **************************************************************************
+
+namespace passes {
+class ImageCache {
+public:
+    static ImageCache* instance();
+
+    QImage find(const QByteArray& key);
+    void insert(const QByteArray& key, const QImage& image);
+
+    void setBudget(qint64 bytes);
+    qint64 getBudget();
+    QVariantMap getStats();
+
+private:
+    ImageCache();
+
+    QMutex mutex;
+    QCache<QByteArray, QImage> images; // cost = bytes of pixel data, least recently used go first
+    quint64 hits;
+    quint64 misses;
+};
+
+} // namespace passes
+
+#endif // IMAGECACHE_H
@@ -0,0 +1,179 @@
+// **************************************************************************
+// class ImageStore
+// 19.10.2026
+// Content addressed store of pass images shared by all passes
+// **************************************************************************
+// MIT License
+// Copyright © 2021 Patrick Fial
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions: The above copyright notice and this
+// permission notice shall be included in all copies or substantial portions of the Software. THE
+// SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+// LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// **************************************************************************
+// includes
+// **************************************************************************
+
+#include "imagestore.h"
+#include "imagecache.h"
+
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QImageReader>
+
+namespace passes {
+// **************************************************************************
+// class ImageStore
+// **************************************************************************
+
+ImageStore* ImageStore::instance()
+{
+    static ImageStore store;
+    return &store;
+}
+
+// **************************************************************************
+// intern
+// **************************************************************************
+
+ImageHandle ImageStore::intern(const QByteArray& data)
+{
+    QByteArray hash = QCryptographicHash::hash(data, QCryptographicHash::Md5);
+
+    {
+        QMutexLocker lock(&mutex);
+
+        if (auto existing = images.value(hash).lock())
+            return existing;
+    }
+
+    // new image, read its header outside of the lock (no pixel data is decoded yet)
+
+    auto image = new StoredImage {hash, data, QSize()};
+
+    QBuffer buffer;
+    buffer.setData(data);
+    buffer.open(QIODevice::ReadOnly);
+
+    QImageReader reader(&buffer);
+    image->size = reader.size();
+
+    if (!reader.canRead() || !image->size.isValid()) {
+        delete image;
+        return nullptr;
+    }
+
+    // entries are dropped together with the last pass referencing them
+
+    ImageHandle handle(image, [this](const StoredImage* image) {
+        remove(image->hash);
+        delete image;
+    });
+
+    QMutexLocker lock(&mutex);
+
+    // another pass might have added the same image meanwhile
+
+    if (auto existing = images.value(hash).lock())
+        return existing;
+
+    images.insert(hash, handle);
+
+    return handle;
+}
+
+// **************************************************************************
+// decode
+// **************************************************************************
+
+QImage ImageStore::decode(const ImageHandle& image, const QSize& scaledSize)
+{
+    if (!image)
+        return QImage();
+
+    // decoded pixels only live in the (memory bounded) image cache, passes only keep the
+    // compressed data
+
+    QByteArray key = image->hash;
+
+    if (scaledSize.isValid())
+        key += "@" + QByteArray::number(scaledSize.width()) + "x"
+               + QByteArray::number(scaledSize.height());
+
+    QImage decoded = ImageCache::instance()->find(key);
+
+    if (!decoded.isNull())
+        return decoded;
+
+    decoded = read(image, scaledSize);
+
+    ImageCache::instance()->insert(key, decoded);
+
+    return decoded;
+}
+
+// **************************************************************************
+// read
+// **************************************************************************
+
+// decodes without going through the image cache, for callers keeping their own (smaller) copy
+
+QImage ImageStore::read(const ImageHandle& image, const QSize& scaledSize) const
+{
+    if (!image)
+        return QImage();
+
+    QBuffer buffer;
+    buffer.setData(image->data);
+    buffer.open(QIODevice::ReadOnly);
+
+    QImageReader reader(&buffer);
+
+    if (scaledSize.isValid())
+        reader.setScaledSize(scaledSize);
+
+    return reader.read();
+}
+
+// **************************************************************************
+// remove
+// **************************************************************************
+
+void ImageStore::remove(const QByteArray& hash)
+{
+    QMutexLocker lock(&mutex);
+
+    auto it = images.find(hash);
+
+    if (it != images.end() && it->expired())
+        images.erase(it);
+}
+
+// **************************************************************************
+// contains
+// **************************************************************************
+
+bool ImageStore::contains(const QByteArray& hash)
+{
+    QMutexLocker lock(&mutex);
+    return !images.value(hash).expired();
+}
+
+// **************************************************************************
+// getCount
+// **************************************************************************
+
+int ImageStore::getCount()
+{
+    QMutexLocker lock(&mutex);
+    return images.size();
+}
+
+} // namespace passes
@@ -0,0 +1,74 @@
+// **************************************************************************
+// class ImageStore
+// 19.10.2026
+// Content addressed store of pass images shared by all passes
+// **************************************************************************
+// MIT License
+// Copyright © 2021 Patrick Fial
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions: The above copyright notice and this
+// permission notice shall be included in all copies or substantial portions of the Software. THE
+// SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+// LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// **************************************************************************
+// includes
+// **************************************************************************
+
+#ifndef IMAGESTORE_H
+#define IMAGESTORE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QSize>
+
+#include <memory>
+
+// **************************************************************************
+// class ImageStore
+// **************************************************************************
+
+namespace passes {
+
+// compressed image data as found in a pass archive. identical files of different passes (bundle
+// members, passes of the same issuer) share one instance.
+
+struct StoredImage {
+    QByteArray hash;
+    QByteArray data;
+    QSize size;
+};
+
+using ImageHandle = std::shared_ptr<const StoredImage>;
+
+class ImageStore {
+public:
+    static ImageStore* instance();
+
+    ImageHandle intern(const QByteArray& data);
+    QImage decode(const ImageHandle& image, const QSize& scaledSize);
+    QImage read(const ImageHandle& image, const QSize& scaledSize) const;
+
+    bool contains(const QByteArray& hash);
+    int getCount();
+
+private:
+    ImageStore() = default;
+
+    void remove(const QByteArray& hash);
+
+    QMutex mutex;
+    QHash<QByteArray, std::weak_ptr<const StoredImage>> images;
+};
+
+} // namespace passes
+
+#endif // IMAGESTORE_H
@@ -0,0 +1,265 @@
+// **************************************************************************
+// class LocationIndex
+// 19.10.2026
+// Spatial index of pass locations and beacons
+// **************************************************************************
+// MIT License
+// Copyright © 2021 Patrick Fial
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions: The above copyright notice and this
+// permission notice shall be included in all copies or substantial portions of the Software. THE
+// SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+// LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// **************************************************************************
+// includes
+// **************************************************************************
+
+#include "locationindex.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace passes {
+// cells are 0.01 degrees (~1.1 km of latitude) wide. relevance circles are at most a kilometer,
+// so a location ends up in a handful of cells.
+
+static const double cellSize = 0.01;
+static const int longitudeCells = 36000;
+static const double earthRadius = 6371000.0;
+static const double metersPerDegree = earthRadius * M_PI / 180.0;
+
+// **************************************************************************
+// class LocationIndex
+// **************************************************************************
+
+LocationIndex::LocationIndex() : generation(0) {}
+
+// **************************************************************************
+// distance
+// **************************************************************************
+
+// great circle distance in meters (haversine)
+
+double LocationIndex::distance(double lat1, double lon1, double lat2, double lon2)
+{
+    double dLat = (lat2 - lat1) * M_PI / 180.0;
+    double dLon = (lon2 - lon1) * M_PI / 180.0;
+    double a = std::sin(dLat / 2) * std::sin(dLat / 2)
+               + std::cos(lat1 * M_PI / 180.0) * std::cos(lat2 * M_PI / 180.0)
+                     * std::sin(dLon / 2) * std::sin(dLon / 2);
+
+    return 2 * earthRadius * std::asin(std::sqrt(qMin(a, 1.0)));
+}
+
+// **************************************************************************
+// relevantDistance
+// **************************************************************************
+
+// boarding passes and event tickets are relevant in a wider area, maxDistance may only shrink it
+
+double LocationIndex::relevantDistance(const PassPtr& pass)
+{
+    const auto& style = pass->details.style;
+    double res = (style == "boardingPass" || style == "eventTicket") ? 1000.0 : 100.0;
+
+    if (pass->standard.maxDistance > 0)
+        res = qMin(res, double(pass->standard.maxDistance));
+
+    return res;
+}
+
+// **************************************************************************
+// cells
+// **************************************************************************
+
+int LocationIndex::latitudeCell(double latitude)
+{
+    return int(std::floor(latitude / cellSize));
+}
+
+int LocationIndex::longitudeCell(double longitude)
+{
+    int cell = int(std::floor((longitude + 180.0) / cellSize)) % longitudeCells;
+    return cell < 0 ? cell + longitudeCells : cell;
+}
+
+quint64 LocationIndex::cellKey(int latCell, int lonCell)
+{
+    return (quint64(quint32(latCell)) << 32) | quint32(lonCell);
+}
+
+// **************************************************************************
+// collect
+// **************************************************************************
+
+void LocationIndex::collect(const QString& id, const PassPtr& pass)
+{
+    double radius = relevantDistance(pass);
+
+    for (const auto& location : pass->standard.locations) {
+        Entry entry { id, location.latitude, location.longitude, radius };
+
+        // bounding box of the relevance circle. longitude degrees shrink towards the poles, so
+        // they are measured at the circle's edge closest to the pole.
+
+        double latSpan = radius / metersPerDegree;
+        double poleward = qMin(qAbs(location.latitude) + latSpan, 90.0);
+        double scale = std::cos(poleward * M_PI / 180.0);
+        double lonSpan = scale > 0.001 ? qMin(radius / (metersPerDegree * scale), 180.0) : 180.0;
+
+        int latFrom = latitudeCell(qMax(location.latitude - latSpan, -90.0));
+        int latTo = latitudeCell(qMin(location.latitude + latSpan, 90.0));
+        int lonFrom = int(std::floor((location.longitude + 180.0 - lonSpan) / cellSize));
+        int lonTo = int(std::floor((location.longitude + 180.0 + lonSpan) / cellSize));
+
+        if (lonTo - lonFrom >= longitudeCells)
+            lonTo = lonFrom + longitudeCells - 1;
+
+        auto& list = cellsOf[id];
+
+        for (int latCell = latFrom; latCell <= latTo; latCell++) {
+            for (int lon = lonFrom; lon <= lonTo; lon++) {
+                int lonCell = ((lon % longitudeCells) + longitudeCells) % longitudeCells;
+                auto key = cellKey(latCell, lonCell);
+
+                cells[key].push_back(entry);
+                list.push_back(key);
+            }
+        }
+    }
+
+    for (const auto& beacon : pass->standard.beacons) {
+        beacons[beacon.proximityUUID].push_back({ id, beacon.major, beacon.minor });
+        beaconsOf[id] << beacon.proximityUUID;
+    }
+
+    for (const auto& bundlePass : pass->bundlePasses)
+        collect(id, bundlePass);
+}
+
+// **************************************************************************
+// add
+// **************************************************************************
+
+void LocationIndex::add(const QString& id, const PassPtr& pass)
+{
+    remove(id);
+    collect(id, pass);
+    generation++;
+}
+
+// **************************************************************************
+// remove
+// **************************************************************************
+
+void LocationIndex::remove(const QString& id)
+{
+    auto byId = [&id](const auto& entry) { return entry.id == id; };
+
+    auto it = cellsOf.find(id);
+
+    if (it != cellsOf.end()) {
+        for (auto key : *it) {
+            auto cell = cells.find(key);
+
+            if (cell == cells.end())
+                continue;
+
+            cell->erase(std::remove_if(cell->begin(), cell->end(), byId), cell->end());
+
+            if (cell->isEmpty())
+                cells.erase(cell);
+        }
+
+        cellsOf.erase(it);
+    }
+
+    auto uuids = beaconsOf.find(id);
+
+    if (uuids != beaconsOf.end()) {
+        for (const auto& uuid : *uuids) {
+            auto list = beacons.find(uuid);
+
+            if (list == beacons.end())
+                continue;
+
+            list->erase(std::remove_if(list->begin(), list->end(), byId), list->end());
+
+            if (list->isEmpty())
+                beacons.erase(list);
+        }
+
+        beaconsOf.erase(uuids);
+    }
+
+    generation++;
+}
+
+// **************************************************************************
+// clear
+// **************************************************************************
+
+void LocationIndex::clear()
+{
+    cells.clear();
+    cellsOf.clear();
+    beacons.clear();
+    beaconsOf.clear();
+    generation++;
+}
+
+// **************************************************************************
+// relevantAt
+// **************************************************************************
+
+QHash<QString, double> LocationIndex::relevantAt(double latitude, double longitude) const
+{
+    QHash<QString, double> result;
+    auto it = cells.find(cellKey(latitudeCell(latitude), longitudeCell(longitude)));
+
+    if (it == cells.end())
+        return result;
+
+    for (const auto& entry : *it) {
+        double d = distance(latitude, longitude, entry.latitude, entry.longitude);
+
+        if (d > entry.radius)
+            continue;
+
+        auto found = result.find(entry.id);
+
+        if (found == result.end())
+            result.insert(entry.id, d);
+        else if (d < *found)
+            *found = d;
+    }
+
+    return result;
+}
+
+// **************************************************************************
+// findByBeacon
+// **************************************************************************
+
+// beacons without major/minor match any major/minor of their proximity uuid
+
+QSet<QString> LocationIndex::findByBeacon(const QString& proximityUUID, int major, int minor) const
+{
+    QSet<QString> result;
+
+    for (const auto& entry : beacons.value(proximityUUID.toUpper())) {
+        if ((entry.major < 0 || entry.major == major) && (entry.minor < 0 || entry.minor == minor))
+            result.insert(entry.id);
+    }
+
+    return result;
+}
+
+} // namespace passes
@@ -0,0 +1,91 @@
+// **************************************************************************
+// class LocationIndex
+// 19.10.2026
+// Spatial index of pass locations and beacons
+// **************************************************************************
+// MIT License
+// Copyright © 2021 Patrick Fial
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions: The above copyright notice and this
+// permission notice shall be included in all copies or substantial portions of the Software. THE
+// SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+// LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// **************************************************************************
+// includes
+// **************************************************************************
+
+#ifndef LOCATIONINDEX_H
+#define LOCATIONINDEX_H
+
+#include <QHash>
+#include <QSet>
+#include <QVector>
+
+#include "pkpass.h"
+
+// **************************************************************************
+// class LocationIndex
+// **************************************************************************
+
+// the locations of all passes, bucketed into a grid of fixed size cells. a location is entered
+// into every cell its relevance circle touches, so the passes relevant at a position are found by
+// looking at the single cell containing it.
+
+namespace passes {
+class LocationIndex {
+public:
+    LocationIndex();
+
+    void add(const QString& id, const PassPtr& pass);
+    void remove(const QString& id);
+    void clear();
+
+    // pass id -> distance (in meters) to its closest location, for all passes relevant here
+
+    QHash<QString, double> relevantAt(double latitude, double longitude) const;
+    QSet<QString> findByBeacon(const QString& proximityUUID, int major, int minor) const;
+
+    quint64 getGeneration() const
+    {
+        return generation;
+    }
+
+    static double distance(double lat1, double lon1, double lat2, double lon2);
+    static double relevantDistance(const PassPtr& pass);
+
+private:
+    struct Entry {
+        QString id;
+        double latitude;
+        double longitude;
+        double radius;
+    };
+
+    struct BeaconEntry {
+        QString id;
+        int major;
+        int minor;
+    };
+
+    void collect(const QString& id, const PassPtr& pass);
+    static int latitudeCell(double latitude);
+    static int longitudeCell(double longitude);
+    static quint64 cellKey(int latCell, int lonCell);
+
+    QHash<quint64, QVector<Entry>> cells;
+    QHash<QString, QVector<quint64>> cellsOf;     // pass id -> cells (for removal)
+    QHash<QString, QVector<BeaconEntry>> beacons; // proximity uuid -> beacons
+    QHash<QString, QStringList> beaconsOf;        // pass id -> proximity uuids
+    quint64 generation;
+};
+
+} // namespace passes
+
+#endif // LOCATIONINDEX_H
@@ -0,0 +1,234 @@
+// **************************************************************************
+// class PassesFilterModel
+// 19.10.2026
+// Passes as shown in the pass list
+// **************************************************************************
+// MIT License
+// Copyright © 2021 Patrick Fial
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions: The above copyright notice and this
+// permission notice shall be included in all copies or substantial portions of the Software. THE
+// SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+// LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// **************************************************************************
+// includes
+// **************************************************************************
+
+#include "passesfiltermodel.h"
+#include "passesmodel.h"
+
+namespace passes {
+// **************************************************************************
+// class PassesFilterModel
+// **************************************************************************
+
+PassesFilterModel::PassesFilterModel(PassesModel* passes)
+  : QSortFilterProxyModel(passes), passes(passes),
+    showExpired(false),
+    searching(false),
+    sortMode(SortByDate),
+    matchesGeneration(0),
+    matchesValid(false),
+    nearby(false),
+    distancesGeneration(0),
+    distancesValid(false)
+{
+    setDynamicSortFilter(true);
+    setSourceModel(passes);
+
+    connect(this, &QAbstractItemModel::rowsInserted, this, &PassesFilterModel::countChanged);
+    connect(this, &QAbstractItemModel::rowsRemoved, this, &PassesFilterModel::countChanged);
+    connect(this, &QAbstractItemModel::modelReset, this, &PassesFilterModel::countChanged);
+    connect(this, &QAbstractItemModel::layoutChanged, this, &PassesFilterModel::countChanged);
+    connect(passes, &PassesModel::positionChanged, this, &PassesFilterModel::positionChanged);
+}
+
+// **************************************************************************
+// setShowExpired
+// **************************************************************************
+
+void PassesFilterModel::setShowExpired(bool show)
+{
+    if (show == showExpired)
+        return;
+
+    showExpired = show;
+    invalidateFilter();
+
+    emit showExpiredChanged();
+}
+
+// **************************************************************************
+// setSearchText
+// **************************************************************************
+
+void PassesFilterModel::setSearchText(const QString& text)
+{
+    if (text == searchText)
+        return;
+
+    searchText = text;
+    searching = !SearchIndex::tokenize(text).isEmpty();
+    matchesValid = false;
+    invalidateFilter();
+
+    emit searchTextChanged();
+}
+
+// **************************************************************************
+// setNearby
+// **************************************************************************
+
+void PassesFilterModel::setNearby(bool enabled)
+{
+    if (enabled == nearby)
+        return;
+
+    nearby = enabled;
+    distancesValid = false;
+    invalidateFilter();
+    updateSorting();
+
+    emit nearbyChanged();
+}
+
+// **************************************************************************
+// setSortMode
+// **************************************************************************
+
+void PassesFilterModel::setSortMode(SortMode mode)
+{
+    if (mode == sortMode)
+        return;
+
+    sortMode = mode;
+    updateSorting();
+
+    emit sortModeChanged();
+}
+
+// **************************************************************************
+// updateSorting
+// **************************************************************************
+
+// the source model is kept ordered by date, so sorting by date means not sorting at all. nearby
+// passes are ordered by distance.
+
+void PassesFilterModel::updateSorting()
+{
+    if (!nearby && sortMode == SortByDate) {
+        sort(-1);
+        return;
+    }
+
+    // sort() skips a repeated call for the same column, so a changed mode needs an invalidate
+
+    invalidate();
+    sort(0);
+}
+
+// **************************************************************************
+// positionChanged
+// **************************************************************************
+
+void PassesFilterModel::positionChanged()
+{
+    distancesValid = false;
+
+    if (nearby)
+        invalidate();
+}
+
+// **************************************************************************
+// filterAcceptsRow
+// **************************************************************************
+
+bool PassesFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex& /*sourceParent*/) const
+{
+    if (nearby && !getDistances().contains(passes->getId(sourceRow)))
+        return false;
+
+    return (showExpired || !passes->isExpired(sourceRow)) && matchesSearch(sourceRow);
+}
+
+// **************************************************************************
+// lessThan
+// **************************************************************************
+
+// only cached keys are compared. equal keys fall back to the source row, which is ordered by date.
+
+bool PassesFilterModel::lessThan(const QModelIndex& left, const QModelIndex& right) const
+{
+    int l = left.row();
+    int r = right.row();
+
+    if (nearby) {
+        const auto& d = getDistances();
+        double a = d.value(passes->getId(l));
+        double b = d.value(passes->getId(r));
+
+        return a < b || (a == b && l < r);
+    }
+
+    const auto& a = passes->passAt(l);
+    const auto& b = passes->passAt(r);
+
+    switch (sortMode) {
+        case SortByOrganization: {
+            int cmp = a->organizationKey.compare(b->organizationKey);
+            return cmp < 0 || (cmp == 0 && l < r);
+        }
+        case SortByExpiry:
+            return a->expiryKey < b->expiryKey || (a->expiryKey == b->expiryKey && l < r);
+        case SortByStyle:
+            return a->styleKey < b->styleKey || (a->styleKey == b->styleKey && l < r);
+        default:
+            return l < r;
+    }
+}
+
+// **************************************************************************
+// getDistances
+// **************************************************************************
+
+const QHash<QString, double>& PassesFilterModel::getDistances() const
+{
+    const auto& index = passes->getLocationIndex();
+
+    if (!distancesValid || distancesGeneration != index.getGeneration()) {
+        distances = passes->relevantHere();
+        distancesGeneration = index.getGeneration();
+        distancesValid = true;
+    }
+
+    return distances;
+}
+
+// **************************************************************************
+// matchesSearch
+// **************************************************************************
+
+bool PassesFilterModel::matchesSearch(int sourceRow) const
+{
+    if (!searching)
+        return true;
+
+    const auto& index = passes->getSearchIndex();
+
+    if (!matchesValid || matchesGeneration != index.getGeneration()) {
+        matches = index.find(searchText);
+        matchesGeneration = index.getGeneration();
+        matchesValid = true;
+    }
+
+    return matches.contains(passes->getId(sourceRow));
+}
+
+} // namespace passes
@@ -0,0 +1,119 @@
+// **************************************************************************
+// class PassesFilterModel
+// 19.10.2026
+// Passes as shown in the pass list
+// **************************************************************************
+// MIT License
+// Copyright © 2021 Patrick Fial
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions: The above copyright notice and this
+// permission notice shall be included in all copies or substantial portions of the Software. THE
+// SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+// LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// **************************************************************************
+// includes
+// **************************************************************************
+
+#ifndef PASSESFILTERMODEL_H
+#define PASSESFILTERMODEL_H
+
+#include <QHash>
+#include <QSet>
+#include <QSortFilterProxyModel>
+
+// **************************************************************************
+// class PassesFilterModel
+// **************************************************************************
+
+// all passes stay loaded in the PassesModel, this proxy decides which of them are listed. the
+// proxy maintains its row mapping incrementally, so changing the filter costs no I/O.
+
+namespace passes {
+class PassesModel;
+
+class PassesFilterModel : public QSortFilterProxyModel {
+    Q_OBJECT
+    Q_PROPERTY(int count READ getCount NOTIFY countChanged)
+    Q_PROPERTY(bool showExpired READ getShowExpired WRITE setShowExpired NOTIFY showExpiredChanged)
+    Q_PROPERTY(QString searchText READ getSearchText WRITE setSearchText NOTIFY searchTextChanged)
+    Q_PROPERTY(bool nearby READ getNearby WRITE setNearby NOTIFY nearbyChanged)
+    Q_PROPERTY(SortMode sortMode READ getSortMode WRITE setSortMode NOTIFY sortModeChanged)
+
+public:
+    enum SortMode { SortByDate, SortByOrganization, SortByExpiry, SortByStyle };
+    Q_ENUM(SortMode)
+
+    explicit PassesFilterModel(PassesModel* passes);
+
+    int getCount() const
+    {
+        return rowCount();
+    }
+    bool getShowExpired() const
+    {
+        return showExpired;
+    }
+    void setShowExpired(bool show);
+    QString getSearchText() const
+    {
+        return searchText;
+    }
+    void setSearchText(const QString& text);
+    bool getNearby() const
+    {
+        return nearby;
+    }
+    void setNearby(bool enabled);
+    SortMode getSortMode() const
+    {
+        return sortMode;
+    }
+    void setSortMode(SortMode mode);
+
+signals:
+    void countChanged();
+    void showExpiredChanged();
+    void searchTextChanged();
+    void nearbyChanged();
+    void sortModeChanged();
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const override;
+    bool lessThan(const QModelIndex& left, const QModelIndex& right) const override;
+
+private:
+    bool matchesSearch(int sourceRow) const;
+    const QHash<QString, double>& getDistances() const;
+    void positionChanged();
+    void updateSorting();
+
+    PassesModel* passes;
+    bool showExpired;
+    QString searchText;
+    bool searching;
+    SortMode sortMode;
+
+    // search result, refreshed whenever the search index changed since it was computed
+
+    mutable QSet<QString> matches;
+    mutable quint64 matchesGeneration;
+    mutable bool matchesValid;
+
+    // passes relevant at the current position, while listing nearby passes only
+
+    bool nearby;
+    mutable QHash<QString, double> distances;
+    mutable quint64 distancesGeneration;
+    mutable bool distancesValid;
+};
+
+} // namespace passes
+
+#endif // PASSESFILTERMODEL_H
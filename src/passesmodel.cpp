@@ -26,7 +26,8 @@
 #include <QStandardPaths>
 
 #include "async.hpp"
-#include "quazip/quazipfile.h"
+#include "imagecache.h"
+#include <algorithm>
 
 namespace C {
 #include <libintl.h>
@@ -40,38 +41,67 @@ namespace passes {
 PassesModel* PassesModel::instance = nullptr;
 
 PassesModel::PassesModel(QObject* parent)
-  : QAbstractListModel(parent), storageReady(false), countExpired(0)
+  : QAbstractListModel(parent), storageReady(false), countExpired(0),
+    havePosition(false), latitude(0.0), longitude(0.0)
 {
+    mFilter = new PassesFilterModel(this);
+    mUpNext = new UpNextModel(this);
+
+    connect(&expiry, &ExpiryScheduler::expired, this, &PassesModel::passExpired);
+
+    // the store does all file I/O on its own thread
+
+    store = new PassStore;
+    store->moveToThread(&storeThread);
+
+    connect(&storeThread, &QThread::finished, store, &QObject::deleteLater);
+    connect(store, &PassStore::initialized, this, &PassesModel::storeInitialized);
+    connect(store, &PassStore::loaded, this, &PassesModel::storeLoaded);
+    connect(store, &PassStore::importProgress, this, &PassesModel::importProgress);
+    connect(store, &PassStore::importStaged, this, &PassesModel::storeImportStaged);
+    connect(store, &PassStore::importCommitted, this, &PassesModel::storeImportCommitted);
+    connect(store, &PassStore::filesRemoved, this, &PassesModel::storeFilesRemoved);
+    connect(store, &PassStore::updateStored, this, &PassesModel::storeUpdateStored);
+
+    storeThread.start();
+
     instance = this;
+
+    qRegisterMetaType<Barcode>();
+    qRegisterMetaType<WebService>();
+    qRegisterMetaType<Standard>();
+    qRegisterMetaType<PassStyleField>();
+    qRegisterMetaType<PassStyle>();
+}
+
+PassesModel::~PassesModel()
+{
+    storeThread.quit();
+    storeThread.wait();
 }
 
 // **************************************************************************
 // init
 // **************************************************************************
 
-QString PassesModel::init()
+void PassesModel::init()
 {
-    QString dataPath = getDataPath();
-
-    if (!dataPath.size())
-        return C::gettext("Failed to determine writable app data storage location");
-
-    QDir dir(dataPath + "/passes");
-
-    if (!dir.exists()) {
-        bool res = dir.mkpath(dataPath + "/passes");
+    QMetaObject::invokeMethod(store, [this, dataPath = getDataPath()]() { store->init(dataPath); });
+}
 
-        if (!res)
-            return QString(C::gettext("App data storage location inaccessible")) + " ("
-                   + QString(C::gettext("can't create subfolder:")) + " " + dir.absolutePath()
-                   + ")";
-    }
+void PassesModel::storeInitialized(const QString& error)
+{
+    storageReady = error.isEmpty();
+    emit initialized(error);
+}
 
-    passesDir.setPath(dir.path());
-    passesDir.setSorting(QDir::Time);
-    storageReady = true;
+// **************************************************************************
+// setDefaultFont
+// **************************************************************************
 
-    return "";
+void PassesModel::setDefaultFont(QFont to)
+{
+    QMetaObject::invokeMethod(store, [this, to]() { store->setDefaultFont(to); });
 }
 
 // **************************************************************************
@@ -80,8 +110,42 @@ QString PassesModel::init()
 
 QVariant PassesModel::data(const QModelIndex& index, int role) const
 {
-    if (role == Qt::DisplayRole || role == PassRole)
-        return static_cast<QVariant>(*(mItems[index.row()]));
+    if (!index.isValid() || index.row() < 0 || index.row() >= (int)mItems.size())
+        return QVariant();
+
+    const auto& pass = mItems[index.row()];
+
+    // bundles are displayed using their first pass
+
+    const auto& shown = pass->bundlePasses.empty() ? pass : pass->bundlePasses.front();
+
+    switch (role) {
+        case Qt::DisplayRole:
+        case PassRole:
+            return QVariant::fromValue(getObject(pass));
+        case IdRole:
+            return pass->id;
+        case OrganizationRole:
+            return shown->standard.organization;
+        case DescriptionRole:
+            return shown->standard.description;
+        case StyleRole:
+            return shown->details.style;
+        case BackgroundColorRole:
+            return shown->standard.backgroundColor;
+        case ForegroundColorRole:
+            return shown->standard.foregroundColor;
+        case LabelColorRole:
+            return shown->standard.labelColor;
+        case ExpiredRole:
+            return isExpired(pass);
+        case BundleCountRole:
+            return (int)pass->bundlePasses.size();
+        case BundlePassesRole:
+            return QVariant::fromValue(getObject(pass)->getBundlePasses());
+        default:
+            break;
+    }
 
     return QVariant();
 }
@@ -103,9 +167,138 @@ QHash<int, QByteArray> PassesModel::roleNames() const
 {
     QHash<int, QByteArray> roles;
     roles[PassRole] = "pass";
+    roles[IdRole] = "passId";
+    roles[OrganizationRole] = "organization";
+    roles[DescriptionRole] = "description";
+    roles[StyleRole] = "style";
+    roles[BackgroundColorRole] = "backgroundColor";
+    roles[ForegroundColorRole] = "foregroundColor";
+    roles[LabelColorRole] = "labelColor";
+    roles[ExpiredRole] = "expired";
+    roles[BundleCountRole] = "bundleCount";
+    roles[BundlePassesRole] = "bundlePasses";
     return roles;
 }
 
+// **************************************************************************
+// pass objects
+// **************************************************************************
+
+// QML gets one object per pass, created when a delegate first asks for it. updates swap the
+// pass inside the object so bindings re-evaluate without recreating the delegate.
+
+PassObject* PassesModel::getObject(const PassPtr& pass) const
+{
+    auto it = mObjects.find(pass->id);
+
+    if (it == mObjects.end())
+        it = mObjects.insert(pass->id, new PassObject(pass, const_cast<PassesModel*>(this)));
+
+    return *it;
+}
+
+void PassesModel::updateObject(const QString& id, const PassPtr& pass)
+{
+    auto object = mObjects.take(id);
+
+    if (!object)
+        return;
+
+    object->setPass(pass);
+    mObjects.insert(pass->id, object);
+}
+
+void PassesModel::releaseObject(const QString& id)
+{
+    if (auto object = mObjects.take(id))
+        object->deleteLater();
+}
+
+// **************************************************************************
+// image cache
+// **************************************************************************
+
+int PassesModel::getImageCacheSize()
+{
+    return ImageCache::instance()->getBudget() / (1024 * 1024);
+}
+
+void PassesModel::setImageCacheSize(int megabytes)
+{
+    ImageCache::instance()->setBudget(qint64(megabytes) * 1024 * 1024);
+}
+
+QVariantMap PassesModel::imageCacheStats()
+{
+    return ImageCache::instance()->getStats();
+}
+
+// **************************************************************************
+// search
+// **************************************************************************
+
+QStringList PassesModel::search(const QString& query) const
+{
+    return searchIndex.find(query).values();
+}
+
+// **************************************************************************
+// setPosition/clearPosition
+// **************************************************************************
+
+void PassesModel::setPosition(double latitude, double longitude)
+{
+    if (havePosition && this->latitude == latitude && this->longitude == longitude)
+        return;
+
+    havePosition = true;
+    this->latitude = latitude;
+    this->longitude = longitude;
+
+    emit positionChanged();
+}
+
+void PassesModel::clearPosition()
+{
+    if (!havePosition)
+        return;
+
+    havePosition = false;
+    emit positionChanged();
+}
+
+// **************************************************************************
+// relevantHere
+// **************************************************************************
+
+// pass id -> distance in meters, for all passes relevant at the current position
+
+QHash<QString, double> PassesModel::relevantHere() const
+{
+    if (!havePosition)
+        return QHash<QString, double>();
+
+    return locationIndex.relevantAt(latitude, longitude);
+}
+
+// **************************************************************************
+// nearby
+// **************************************************************************
+
+// ids of the passes relevant at the current position, closest first
+
+QStringList PassesModel::nearby() const
+{
+    auto distances = relevantHere();
+    QStringList res = distances.keys();
+
+    std::sort(res.begin(), res.end(), [&distances](const QString& a, const QString& b) {
+        return distances.value(a) < distances.value(b);
+    });
+
+    return res;
+}
+
 // **************************************************************************
 // getDataPath
 // **************************************************************************
@@ -116,102 +309,227 @@ QString PassesModel::getDataPath() const
 }
 
 // **************************************************************************
-// readPasses
+// insertPasses
 // **************************************************************************
 
-void PassesModel::readPasses(QVariantList& failed, QMap<QString, PassList>& bundles,
-                             bool doShowExpired)
+// inserts passes at their sorted positions. passes landing next to each other are announced as
+// one range, so showing many expired passes does not end up in one notification per row.
+
+void PassesModel::insertPasses(PassList passes)
 {
-    for (const QFileInfo& info : passesDir.entryInfoList(QDir::Files | QDir::NoSymLinks
-                                                         | QDir::NoDotAndDotDot | QDir::Readable)) {
-        if (info.fileName().startsWith(".") || !info.fileName().endsWith(".pkpass"))
-            continue;
+    std::sort(passes.begin(), passes.end(), passSorter);
 
-        if (doShowExpired && isOpen(info.absoluteFilePath()))
-            continue;
+    mUpNext->beginBatch();
 
-        auto passResult = pkpass.openPass(info.absoluteFilePath());
+    size_t i = 0;
 
-        if (QString* err = std::get_if<QString>(&passResult)) {
-            qDebug() << "Pass open failed: " << *err;
+    while (i < passes.size()) {
+        auto pos = std::upper_bound(mItems.begin(), mItems.end(), passes[i], passSorter);
+        size_t j = i + 1;
 
-            QVariantMap failedPass;
-            failedPass["filePath"] = info.absoluteFilePath();
-            failedPass["error"] = *err;
-            failed.append(failedPass);
-        } else {
-            auto pass = std::get<PassPtr>(passResult);
-
-            if (!pass->bundleName.isEmpty()) {
-                if (!bundles.contains(pass->bundleName)) {
-                    bundles[pass->bundleName] = PassList {pass};
-                } else {
-                    bundles[pass->bundleName].push_back(pass);
-                }
-            } else if (doShowExpired != pass->standard.expired) {
-                if (!doShowExpired)
-                    countExpired++;
-            } else {
-                mItemMap[pass->id] = pass;
-                mItems.push_back(pass);
-            }
+        while (j < passes.size() && (pos == mItems.end() || passSorter(passes[j], *pos)))
+            j++;
+
+        int row = pos - mItems.begin();
+
+        beginInsertRows(QModelIndex(), row, row + (j - i) - 1);
+
+        for (size_t k = i; k < j; k++) {
+            addToIndex(passes[k]);
+
+            if (isExpired(passes[k]))
+                countExpired++;
         }
+
+        mItems.insert(pos, passes.begin() + i, passes.begin() + j);
+
+        endInsertRows();
+
+        i = j;
     }
+
+    mUpNext->endBatch();
 }
 
 // **************************************************************************
-// makeBundlePass
+// removePassRows
 // **************************************************************************
 
-PassPtr makeBundlePass(QString bundleName, PassList& bundlePasses)
+void PassesModel::removePassRows(int first, int last)
 {
-    int idx = 0;
-    auto bundlePass = std::make_shared<Pass>();
-    bundlePass->id = "";
-    bundlePass->bundleName = bundleName;
-    bundlePass->bundleExpired = true;
-    bundlePass->bundlePasses = std::move(bundlePasses);
+    beginRemoveRows(QModelIndex(), first, last);
 
-    for (auto pass : bundlePass->bundlePasses) {
-        if (bundlePass->id == "")
-            bundlePass->id = pass->id;
-        else
-            pass->bundleId = bundlePass->id;
+    for (int row = first; row <= last; row++) {
+        releaseObject(mItems[row]->id);
+        removeFromIndex(mItems[row]);
 
-        if (!pass->standard.expired)
-            bundlePass->bundleExpired = false;
+        if (isExpired(mItems[row]))
+            countExpired--;
+    }
 
-        if (!bundlePass->modified.isValid() || bundlePass->modified.secsTo(pass->modified)) {
-            bundlePass->modified = pass->modified;
-        }
+    mItems.erase(mItems.begin() + first, mItems.begin() + last + 1);
 
-        if (!bundlePass->sortingDate.isValid()
-            || bundlePass->sortingDate.secsTo(pass->sortingDate)) {
-            bundlePass->sortingDate = pass->sortingDate;
-        }
+    endRemoveRows();
+}
 
-        pass->bundleIndex = idx++;
-    }
+// **************************************************************************
+// findRow
+// **************************************************************************
+
+// rows are kept sorted, so the row of a pass is a binary search away. only passes with the very
+// same sort key need to be compared one by one.
+
+int PassesModel::findRow(const PassPtr& pass) const
+{
+    auto range = std::equal_range(mItems.begin(), mItems.end(), pass, passSorter);
+    auto it = std::find(range.first, range.second, pass);
 
-    return bundlePass;
+    return it != range.second ? it - mItems.begin() : -1;
 }
 
 // **************************************************************************
-// addBundlePasses
+// indexes
 // **************************************************************************
 
-void PassesModel::addBundlePasses(QMap<QString, PassList>& bundles, bool doShowExpired)
+static QByteArray barcodeHash(const Barcode& barcode)
 {
-    for (auto bundleName : bundles.keys()) {
-        auto bundlePass = makeBundlePass(bundleName, bundles[bundleName]);
+    return QCryptographicHash::hash(barcode.message.toUtf8(), QCryptographicHash::Md5);
+}
 
-        if (doShowExpired != bundlePass->bundleExpired) {
-            if (!doShowExpired)
-                countExpired++;
-        } else {
-            mItemMap[bundlePass->id] = bundlePass;
-            mItems.push_back(bundlePass);
+// pass type and serial number identify a pass across re-downloads, whatever its signature
+
+static QString serialKey(const PassPtr& pass)
+{
+    const auto& standard = pass->standard;
+
+    if (standard.passTypeIdentifier.isEmpty() || standard.serialNumber.isEmpty())
+        return QString();
+
+    return standard.passTypeIdentifier + "\n" + standard.serialNumber;
+}
+
+void PassesModel::addToIndex(const PassPtr& pass)
+{
+    mItemMap.insert(pass->id, pass);
+    searchIndex.add(pass->id, pass);
+    locationIndex.add(pass->id, pass);
+    mUpNext->add(pass);
+
+    auto add = [this, &pass](const PassPtr& p) {
+        auto serial = serialKey(p);
+
+        if (!serial.isEmpty())
+            mSerialIndex.insert(serial, pass->id);
+
+        for (const auto& barcode : p->standard.barcodes) {
+            if (!barcode.message.isEmpty())
+                mBarcodeIndex.insert(barcodeHash(barcode), pass->id);
+        }
+    };
+
+    add(pass);
+
+    for (const auto& bundlePass : pass->bundlePasses)
+        add(bundlePass);
+
+    // passes expire while the app is running, bundle members are tracked under the bundle's id
+
+    if (!pass->standard.expired)
+        expiry.schedule(pass->id, pass->standard.expiresAt);
+
+    for (const auto& bundlePass : pass->bundlePasses) {
+        if (!bundlePass->standard.expired)
+            expiry.schedule(pass->id, bundlePass->standard.expiresAt);
+    }
+}
+
+void PassesModel::removeFromIndex(const PassPtr& pass)
+{
+    // passes imported before duplicates were rejected may share keys, so a key can be held by
+    // several passes. only the entries of this pass are dropped.
+
+    mItemMap.remove(pass->id);
+    expiry.unschedule(pass->id);
+    searchIndex.remove(pass->id);
+    locationIndex.remove(pass->id);
+    mUpNext->remove(pass->id);
+
+    auto remove = [this, &pass](const PassPtr& p) {
+        auto serial = serialKey(p);
+
+        if (!serial.isEmpty())
+            mSerialIndex.remove(serial, pass->id);
+
+        for (const auto& barcode : p->standard.barcodes)
+            mBarcodeIndex.remove(barcodeHash(barcode), pass->id);
+    };
+
+    remove(pass);
+
+    for (const auto& bundlePass : pass->bundlePasses)
+        remove(bundlePass);
+}
+
+// returns why the pass (or one of its bundle passes) duplicates a listed pass, empty if it doesn't.
+// entries of the pass with id ignoreId don't count, so an update is no duplicate of itself.
+
+QString PassesModel::findDuplicate(const PassPtr& pass, const QString& ignoreId) const
+{
+    auto other = [&ignoreId](const QString& id) { return !id.isEmpty() && id != ignoreId; };
+
+    auto otherIn = [&other](const QList<QString>& ids) {
+        return std::any_of(ids.begin(), ids.end(), other);
+    };
+
+    auto find = [this, &other, &otherIn](const PassPtr& p) {
+        auto serial = serialKey(p);
+        bool samePass = (mItemMap.contains(p->id) && other(p->id))
+                        || (!serial.isEmpty() && otherIn(mSerialIndex.values(serial)));
+
+        if (samePass)
+            return QString(C::gettext("Same pass has already been imported"));
+
+        for (const auto& barcode : p->standard.barcodes) {
+            if (!barcode.message.isEmpty() && otherIn(mBarcodeIndex.values(barcodeHash(barcode))))
+                return QString(C::gettext("Pass with the same barcode has already been imported"));
         }
+
+        return QString();
+    };
+
+    QString err = find(pass);
+
+    for (size_t i = 0; err.isEmpty() && i < pass->bundlePasses.size(); i++)
+        err = find(pass->bundlePasses[i]);
+
+    return err;
+}
+
+// keys of staged passes, see ImportKeys
+
+static QString findImportKey(const ImportKeys& keys, const PassPtr& pass)
+{
+    if (keys.ids.contains(pass->id) || keys.serials.contains(serialKey(pass)))
+        return QString(C::gettext("Same pass has already been imported"));
+
+    for (const auto& barcode : pass->standard.barcodes) {
+        if (!barcode.message.isEmpty() && keys.barcodes.contains(barcodeHash(barcode)))
+            return QString(C::gettext("Pass with the same barcode has already been imported"));
+    }
+
+    return QString();
+}
+
+static void addImportKey(ImportKeys& keys, const PassPtr& pass)
+{
+    keys.ids.insert(pass->id);
+
+    if (!serialKey(pass).isEmpty())
+        keys.serials.insert(serialKey(pass));
+
+    for (const auto& barcode : pass->standard.barcodes) {
+        if (!barcode.message.isEmpty())
+            keys.barcodes.insert(barcodeHash(barcode));
     }
 }
 
@@ -221,47 +539,50 @@ void PassesModel::addBundlePasses(QMap<QString, PassList>& bundles, bool doShowE
 
 void PassesModel::reload()
 {
-    if (!storageReady || !passesDir.path().size()) {
+    if (!storageReady) {
         qDebug() << "Storage directory not initialized";
         return;
     }
 
+    QMetaObject::invokeMethod(store, [this]() { store->load(); });
+}
+
+// the store's snapshot replaces everything listed so far
+
+void PassesModel::storeLoaded(const PassList& passes, const QVariantList& failed)
+{
     beginResetModel();
+    mUpNext->beginBatch();
 
     mItems.clear();
     mItemMap.clear();
+    mBarcodeIndex.clear();
+    mSerialIndex.clear();
+    expiry.clear();
+    searchIndex.clear();
+    locationIndex.clear();
+    mUpNext->clear();
     countExpired = 0;
 
-    QVariantList failed;
-    QMap<QString, PassList> bundles;
-
-    // loop bundles first, and extract the .pkpass files contained, so they will be picked up by the
-    // next loop
+    for (auto object : mObjects)
+        object->deleteLater();
 
-    for (const QFileInfo& info : passesDir.entryInfoList(QDir::Files | QDir::NoSymLinks
-                                                         | QDir::NoDotAndDotDot | QDir::Readable)) {
-        if (info.fileName().startsWith(".") || !info.fileName().endsWith(".pkpasses"))
-            continue;
+    mObjects.clear();
 
-        auto res = pkpass.extractBundle(info);
+    PassList found = passes;
 
-        if (QString* err = std::get_if<QString>(&res)) {
-            qDebug() << "Bundle extract failed: " << *err;
-
-            QVariantMap failedPass;
-            failedPass["filePath"] = info.absoluteFilePath();
-            failedPass["error"] = *err;
-            failed.append(failedPass);
-        }
-    };
+    std::sort(found.begin(), found.end(), passSorter);
 
-    // actually open all available .pkpass files
+    for (const auto& pass : found) {
+        addToIndex(pass);
 
-    readPasses(failed, bundles, false);
-    addBundlePasses(bundles, false);
+        if (isExpired(pass))
+            countExpired++;
+    }
 
-    std::sort(mItems.begin(), mItems.end(), passSorter);
+    mItems = std::move(found);
 
+    mUpNext->endBatch();
     endResetModel();
     emit countExpiredChanged();
     emit countChanged();
@@ -270,32 +591,17 @@ void PassesModel::reload()
         qDebug() << failed.length() << " passed failed to open";
         emit failedPasses(failed);
     }
+
+    emit passesLoaded();
 }
 
 // **************************************************************************
-// openPasses
+// showExpired
 // **************************************************************************
 
 void PassesModel::showExpired()
 {
-    size_t oldCount = mItems.size();
-    QVariantList failed;
-    QMap<QString, PassList> bundles;
-
-    readPasses(failed, bundles, true);
-    addBundlePasses(bundles, true);
-
-    if (failed.length()) {
-        qDebug() << failed.length() << " passed failed to open";
-        emit failedPasses(failed);
-    }
-
-    if (mItems.size() != oldCount) {
-        std::sort(mItems.begin(), mItems.end(), passSorter);
-        beginResetModel();
-        endResetModel();
-        emit countChanged();
-    }
+    mFilter->setShowExpired(true);
 }
 
 // **************************************************************************
@@ -304,183 +610,224 @@ void PassesModel::showExpired()
 
 void PassesModel::hideExpired()
 {
-    size_t oldCount = mItems.size();
+    mFilter->setShowExpired(false);
+}
 
-    for (auto it = mItems.begin(); it != mItems.end();) {
-        if ((*it)->standard.expired || (*it)->bundleExpired) {
-            mItemMap.erase((*it)->id);
-            it = mItems.erase(it);
-        } else {
-            it++;
-        }
-    }
+// **************************************************************************
+// isExpired
+// **************************************************************************
 
-    if (mItems.size() != oldCount) {
-        beginResetModel();
-        endResetModel();
-        emit countChanged();
-    }
+bool PassesModel::isExpired(const PassPtr& pass)
+{
+    return pass->bundlePasses.empty() ? pass->standard.expired : pass->bundleExpired;
+}
+
+bool PassesModel::isExpired(int row) const
+{
+    return row >= 0 && row < (int)mItems.size() && isExpired(mItems[row]);
 }
 
 // **************************************************************************
-// isOpen
+// passExpired
 // **************************************************************************
 
-bool PassesModel::isOpen(const QString& filePath)
+// called by the expiry scheduler once a pass (or a member of a bundle) reached its deadline. the
+// row only changes its data, the filter proxy takes care of hiding it.
+
+void PassesModel::passExpired(const QString& id)
 {
-    auto it = std::find_if(mItems.begin(), mItems.end(),
-                           [&filePath](PassPtr pass) { return pass->filePath == filePath; });
+    auto pass = mItemMap.value(id);
+
+    if (!pass)
+        return;
+
+    QDateTime now = QDateTime::currentDateTime();
+    bool wasExpired = isExpired(pass);
+
+    auto expire = [&now](const PassPtr& p) {
+        if (p->standard.expiresAt.isValid() && p->standard.expiresAt <= now)
+            p->standard.expired = true;
+    };
+
+    if (pass->bundlePasses.empty()) {
+        expire(pass);
+    } else {
+        pass->bundleExpired = true;
+
+        for (const auto& bundlePass : pass->bundlePasses) {
+            expire(bundlePass);
+
+            if (!bundlePass->standard.expired)
+                pass->bundleExpired = false;
+        }
+    }
+
+    if (auto object = mObjects.value(id))
+        object->refresh();
+
+    int row = findRow(pass);
+
+    if (row >= 0)
+        emit dataChanged(index(row), index(row));
 
-    return it != mItems.end();
+    if (!wasExpired && isExpired(pass)) {
+        countExpired++;
+        emit countExpiredChanged();
+    }
+
+    mUpNext->refresh();
 }
 
 // **************************************************************************
 // importPass
 // **************************************************************************
 
-QString PassesModel::importPass(const QString& filePath, bool expiredShown)
+void PassesModel::importPass(const QString& filePath)
 {
-    QString fp = filePath;
+    importPasses(QStringList {filePath});
+}
 
-    if (fp.startsWith("file://"))
-        fp.remove("file://");
+// passes and directories are staged and parsed by the store, duplicates are dropped here and the
+// rest is committed as a whole. errors are reported per file, like failedPasses().
 
-    if (!storageReady)
-        return C::gettext("Storage directory inaccessible, cannot import pass");
+void PassesModel::importPasses(const QStringList& filePaths)
+{
+    QMetaObject::invokeMethod(store, [this, filePaths]() { store->importPasses(filePaths); });
+}
 
-    if (!QFile::exists(fp))
-        return C::gettext("File path of the pass seems to be invalid");
+void PassesModel::storeImportStaged(const QString& stagingPath, const PassList& passes,
+                                    const QStringList& sources, const QVariantList& failed)
+{
+    PassList accepted;
+    QStringList acceptedSources;
+    QVariantList rejected = failed;
 
-    QFileInfo info(fp);
-    QString targetPath = passesDir.path() + "/" + info.fileName();
+    // the batch is also checked against itself and against batches still waiting for their
+    // commit, whose passes are not in the index yet
 
-    if (QFile::exists(targetPath))
-        return C::gettext("Same pass has already been imported");
+    ImportKeys batch;
 
-    QFile sourceFile(fp);
-    bool res = sourceFile.copy(targetPath);
+    auto findPending = [&](const PassPtr& p) {
+        QString err = findImportKey(batch, p);
 
-    if (!res) {
-        return QString(C::gettext("Failed to import pass into storage directory ")) + " ("
-               + sourceFile.errorString() + ")";
-    }
+        for (auto it = pendingImports.cbegin(); err.isEmpty() && it != pendingImports.cend(); ++it)
+            err = findImportKey(*it, p);
+
+        return err;
+    };
 
-    info.setFile(targetPath);
+    for (size_t i = 0; i < passes.size(); i++) {
+        const auto& pass = passes[i];
+        auto err = findDuplicate(pass);
 
-    PassPtr pass;
+        PassList members {pass};
+        members.insert(members.end(), pass->bundlePasses.begin(), pass->bundlePasses.end());
 
-    if (info.fileName().endsWith(".pkpasses")) {
-        auto bundleName = info.baseName();
-        auto extractRes = pkpass.extractBundle(info.absoluteFilePath());
+        for (size_t j = 0; j < members.size() && err.isEmpty(); j++)
+            err = findPending(members[j]);
 
-        if (QString* err = std::get_if<QString>(&extractRes)) {
-            return QString(C::gettext("Failed to extract pass bundle (%1)")).arg(*err);
+        if (!err.isEmpty()) {
+            QVariantMap failedPass;
+            failedPass["filePath"] = sources.value(i);
+            failedPass["error"] = err;
+            rejected.append(failedPass);
+            continue;
         }
 
-        pass = makeBundlePass(bundleName, std::get<PassList>(extractRes));
-    } else {
-        auto passResult = pkpass.openPass(info.absoluteFilePath());
+        for (const auto& member : members)
+            addImportKey(batch, member);
 
-        if (QString* err = std::get_if<QString>(&passResult)) {
-            qDebug() << "Pass open failed: " << *err;
+        accepted.push_back(pass);
+        acceptedSources << sources.value(i);
+    }
 
-            QFile::remove(targetPath);
+    pendingImports.insert(stagingPath, batch);
 
-            return QString(C::gettext("Failed to open pass")) + " (" + *err + ")";
-        }
+    QMetaObject::invokeMethod(store, [this, stagingPath, accepted, acceptedSources, rejected]() {
+        store->commitImport(stagingPath, accepted, acceptedSources, rejected);
+    });
+}
 
-        pass = std::get<PassPtr>(passResult);
-    }
+// the whole batch is inserted at once, its keys are in the index from now on
 
-    auto it = std::find_if(mItems.begin(), mItems.end(),
-                           [&pass](PassPtr p) { return p->id == pass->id; });
+void PassesModel::storeImportCommitted(const QString& stagingPath, const PassList& passes,
+                                       const QVariantList& failed)
+{
+    pendingImports.remove(stagingPath);
 
-    if (it != mItems.end()) {
-        QFile::remove(targetPath);
-        return C::gettext("Pass with the same barcode has already been imported");
-    } else if (pass->standard.expired && !expiredShown) {
-        countExpired++;
-    } else {
-        if (pass->standard.expired)
-            countExpired++;
+    if (!passes.empty()) {
+        insertPasses(passes);
 
-        mItemMap[pass->id] = pass;
-        mItems.push_back(pass);
+        emit countChanged();
+        emit countExpiredChanged();
     }
 
-    std::sort(mItems.begin(), mItems.end(), passSorter);
-    beginResetModel();
-    endResetModel();
-    emit countChanged();
-    emit countExpiredChanged();
+    if (failed.length())
+        emit importFailed(failed);
 
-    return "";
+    emit importFinished(passes.size());
 }
 
 // **************************************************************************
 // deleteFile
 // **************************************************************************
 
-QString PassesModel::deleteFile(QString filePath)
+void PassesModel::deleteFile(const QString& filePath)
 {
-    if (!QFile::exists(filePath))
-        return C::gettext("Failed to delete pass (pass unknown)");
-
-    QFile passFile(filePath);
-    bool res = passFile.remove();
-
-    if (!res)
-        return QString(C::gettext("Failed to delete pass from storage directory (%1)"))
-          .arg(passFile.errorString());
-
-    return "";
+    QMetaObject::invokeMethod(store, [this, filePath]() {
+        store->removeFiles(QString(), QStringList { filePath });
+    });
 }
 
 // **************************************************************************
 // deletePass
 // **************************************************************************
 
-QString PassesModel::deletePass(QString id)
+void PassesModel::deletePass(const QString& id)
 {
-    auto it = std::find_if(mItems.begin(), mItems.end(),
-                           [&id](PassPtr pass) { return pass->id == id; });
+    auto pass = mItemMap.value(id);
 
-    if (it == mItems.end() || !mItemMap.count(id))
-        return C::gettext("Failed to delete pass (pass unknown)");
+    if (!pass) {
+        emit passDeleted(id, "", C::gettext("Failed to delete pass (pass unknown)"));
+        return;
+    }
 
-    auto pass = mItemMap[id];
+    QStringList filePaths;
 
     if (pass->bundlePasses.size() > 0) {
-        for (auto bundlePass : pass->bundlePasses) {
-            QFile passFile(bundlePass->filePath);
-            bool res = passFile.remove();
-
-            if (!res)
-                return QString(C::gettext("Failed to delete pass from storage directory (%1)"))
-                  .arg(passFile.errorString());
+        for (const auto& bundlePass : pass->bundlePasses) {
+            if (!filePaths.contains(bundlePass->filePath))
+                filePaths << bundlePass->filePath;
         }
     } else {
-        QFile passFile(pass->filePath);
-        bool res = passFile.remove();
-
-        if (!res)
-            return QString(C::gettext("Failed to delete pass from storage directory (%1)"))
-              .arg(passFile.errorString());
+        filePaths << pass->filePath;
     }
 
-    if (pass->standard.expired) {
-        countExpired--;
-        emit countExpiredChanged();
+    QMetaObject::invokeMethod(store,
+                              [this, id, filePaths]() { store->removeFiles(id, filePaths); });
+}
+
+// the row goes once its files are gone. files without id were deleted through deleteFile().
+
+void PassesModel::storeFilesRemoved(const QString& id, const QStringList& filePaths,
+                                    const QString& error)
+{
+    if (id.isEmpty()) {
+        emit fileDeleted(filePaths.value(0), error);
+        return;
     }
 
-    beginResetModel();
+    auto pass = mItemMap.value(id);
+    int row = pass ? findRow(pass) : -1;
 
-    mItemMap.erase(pass->id);
-    mItems.erase(it);
+    if (error.isEmpty() && row >= 0) {
+        removePassRows(row, row);
 
-    endResetModel();
-    emit countChanged();
-    return "";
+        emit countChanged();
+        emit countExpiredChanged();
+    }
+
+    emit passDeleted(id, filePaths.value(0), error);
 }
 
 // **************************************************************************
@@ -489,34 +836,82 @@ QString PassesModel::deletePass(QString id)
 
 void PassesModel::fetchPassUpdates()
 {
+    // imports and deletions may change the rows while updates are fetched, so a copy is walked
+
+    auto queue = std::make_shared<PassList>(mItems);
+
     async::eachSeries<PassPtr>(
-      mItems,
-      [this](PassPtr pass, auto next, int index) {
+      *queue,
+      [this](PassPtr pass, auto next, int /*index*/) {
           if (pass->webservice.accessToken.isEmpty() || pass->webservice.webserviceBroken)
               return next("");
 
-          this->fetchPassUpdate(pass, [this, pass, index, next](PassResult passResult) {
-              auto modelIndex = this->createIndex(index, 0);
+          this->fetchPassUpdate(pass, [this, pass, next](PassResult passResult) {
+              // rows may have moved while the request was running
+
+              int row = findRow(pass);
 
               pass->updateError = "";
 
-              if (QString* err = std::get_if<QString>(&passResult)) {
-                  if (!err->isEmpty()) {
-                      pass->updateError = *err;
-                      this->emit dataChanged(modelIndex, modelIndex);
+              if (row < 0)
+                  return next("");
+
+              // an update that duplicates another listed pass is refused like an import would
+              // be, it must not take over the other pass' row, object or index entries
+
+              QString* err = std::get_if<QString>(&passResult);
+              QString duplicate = err ? QString() : findDuplicate(std::get<PassPtr>(passResult),
+                                                                  pass->id);
+
+              if (err || !duplicate.isEmpty()) {
+                  pass->updateError = err ? *err : duplicate;
+
+                  if (!pass->updateError.isEmpty()) {
+                      if (auto object = mObjects.value(pass->id))
+                          object->refresh();
+
+                      this->emit dataChanged(index(row), index(row));
                   }
               } else {
                   auto newPass = std::get<PassPtr>(passResult);
-                  mItemMap[newPass->id] = newPass;
-                  mItems[index] = newPass;
+                  bool expiredChanged = isExpired(pass) != isExpired(newPass);
+
+                  // the update might have changed the sorting date. the new row is searched in
+                  // the rows without this one, so mItems stays sorted whenever listeners look.
+
+                  auto rowPos = mItems.begin() + row;
+                  auto pos = std::upper_bound(mItems.begin(), rowPos, newPass, passSorter);
+
+                  if (pos == rowPos)
+                      pos = std::upper_bound(rowPos + 1, mItems.end(), newPass, passSorter) - 1;
+
+                  int to = pos - mItems.begin();
+
+                  removeFromIndex(pass);
+                  addToIndex(newPass);
+                  updateObject(pass->id, newPass);
+
+                  if (to != row) {
+                      beginMoveRows(QModelIndex(), row, row, QModelIndex(), to > row ? to + 1 : to);
+                      mItems.erase(mItems.begin() + row);
+                      mItems.insert(mItems.begin() + to, newPass);
+                      endMoveRows();
+                  } else {
+                      mItems[row] = newPass;
+                  }
+
+                  if (expiredChanged) {
+                      countExpired += isExpired(newPass) ? 1 : -1;
+                      emit countExpiredChanged();
+                  }
 
-                  this->emit dataChanged(modelIndex, modelIndex);
+                  this->emit dataChanged(index(to), index(to));
               }
 
               return next("");
           });
       },
-      [this](QString err) { emit passUpdatesFetched(err); });
+      [this, queue](QString err) { emit passUpdatesFetched(err); });
 }
 
 // **************************************************************************
@@ -547,147 +942,50 @@ void PassesModel::fetchPassUpdate(PassPtr pass, ResultCallback<PassPtr> callback
                               .arg(code)});
           }
 
-          // try to open the payload (= new pass)
-          // if successful, swap pass objects in model & on filesystem and delete the old one.
+          // the store opens the payload (= new pass) and replaces the old file with it
 
-          auto tempFileName = pass->filePath + ".tmp";
-          QFile tempFile(tempFileName);
+          pendingUpdates.insert(pass->id, callback);
 
-          auto fileRes = tempFile.open(QIODevice::WriteOnly | QIODevice::Truncate);
-
-          if (!fileRes)
-              return callback(PassResult {
-                QString(
-                  C::gettext("Failed to save pass update to storage / could not open file (%1)"))
-                  .arg(tempFile.errorString())});
-
-          fileRes = tempFile.write(body);
-
-          if (!fileRes)
-              return callback(PassResult {
-                QString(
-                  C::gettext("Failed to save pass update to storage / could not write file (%1)"))
-                  .arg(tempFile.errorString())});
-
-          tempFile.close();
-
-          QFileInfo info(tempFileName);
-
-          auto passResult = pkpass.openPass(info);
-
-          if (std::holds_alternative<PassPtr>(passResult)) {
-              QFile::remove(pass->filePath);
-
-              fileRes = tempFile.rename(pass->filePath);
+          QMetaObject::invokeMethod(
+            store, [this, id = pass->id, filePath = pass->filePath, body]() {
+                store->storeUpdate(id, filePath, body);
+            });
+      });
+}
 
-              if (!fileRes) {
-                  return callback(PassResult {
-                    QString(
-                      C::gettext(
-                        "Failed to save pass update to storage / could replace existing pass (%1)"))
-                      .arg(tempFile.errorString())});
-              }
-          } else
-              QFile::remove(tempFileName);
+void PassesModel::storeUpdateStored(const QString& id, const PassResult& result)
+{
+    auto callback = pendingUpdates.take(id);
 
-          return callback(passResult);
-      });
+    if (callback)
+        callback(result);
 }
 
 // **************************************************************************
 // createExportBundle
 // **************************************************************************
 
-QVariant PassesModel::createExportBundle(const QString& bundleId)
-{
-    QVariantMap result;
-
-    if (!mItemMap.count(bundleId)) {
-        result.insert("error", C::gettext("Failed to export pass bundle (pass unknown)"));
-        return result;
-    }
-
-    auto bundlePass = mItemMap[bundleId];
-
-    QString targetPath = passesDir.path() + "/" + bundlePass->bundleName + ".pkpasses";
-
-    int n = 0;
-
-    while (QFile::exists(targetPath) && ++n < 100) {
-        targetPath = passesDir.path() + "/" + bundlePass->bundleName + "_" + QString::number(n)
-                     + ".pkpasses";
-    }
-
-    if (QFile::exists(targetPath)) {
-        result.insert("error",
-                      C::gettext("Failed to export pass bundle (cant create bundle file)"));
-        return result;
-    }
+// bundles are stored as the archive they were imported as, so sharing it needs no copy
 
-    QuaZip archive(targetPath);
-
-    bool res = archive.open(QuaZip::mdCreate);
+void PassesModel::createExportBundle(const QString& bundleId)
+{
+    auto bundlePass = mItemMap.value(bundleId);
 
-    if (!res) {
-        result.insert("error",
-                      C::gettext("Failed to export pass bundle (failed to create archive)"));
-        return result;
+    if (!bundlePass || bundlePass->bundlePasses.empty()) {
+        emit bundleExported(bundleId, "",
+                            C::gettext("Failed to export pass bundle (pass unknown)"));
+        return;
     }
 
-    for (auto pass : bundlePass->bundlePasses) {
-        QFileInfo fileInfo(pass->filePath);
-        QString passFileName
-          = fileInfo.fileName().remove("BUNDLE_" + bundlePass->bundleName + "_BUNDLE_");
-
-        QuaZipNewInfo info(passFileName);
-        info.setPermissions(QFileDevice::ReadOwner | QFileDevice::WriteOwner
-                            | QFileDevice::WriteUser | QFileDevice::ReadUser
-                            | QFileDevice::ReadGroup | QFileDevice::ReadOther);
-
-        QuaZipFile zipFile(&archive);
-
-        res = zipFile.open(QIODevice::WriteOnly, info);
-
-        if (!res) {
-            archive.close();
-            QFile::remove(targetPath);
-            result.insert(
-              "error", C::gettext("Failed to export pass bundle (failed to add file to archive)"));
-            return result;
-        }
-
-        QFile inputFile(pass->filePath);
-
-        res = inputFile.open(QIODevice::ReadOnly);
-
-        if (!res) {
-            zipFile.close();
-            archive.close();
-            QFile::remove(targetPath);
-            result.insert("error",
-                          C::gettext("Failed to export pass bundle (failed to read input file)"));
-            return result;
-        }
+    auto filePath = bundlePass->bundlePasses.front()->filePath;
 
-        auto contents = inputFile.readAll();
-        auto written = zipFile.write(contents);
-
-        inputFile.close();
-        zipFile.close();
-
-        if (written < 0 || written < contents.size()) {
-            archive.close();
-            QFile::remove(targetPath);
-            result.insert("error",
-                          C::gettext("Failed to export pass bundle (failed to read input file))"));
-            return result;
-        }
+    if (!filePath.endsWith(".pkpasses")) {
+        emit bundleExported(bundleId, "",
+                            C::gettext("Failed to export pass bundle (bundle archive missing)"));
+        return;
     }
 
-    archive.close();
-    result.insert("filePath", targetPath);
-
-    return result;
+    emit bundleExported(bundleId, filePath, "");
 }
 
 } // namespace passes
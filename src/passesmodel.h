@@ -25,11 +25,19 @@
 #define PASSESMODEL_H
 
 #include <QAbstractListModel>
-#include <QDir>
 #include <QFont>
 #include <QObject>
+#include <QSet>
+#include <QThread>
 
+#include "expiryscheduler.h"
+#include "locationindex.h"
 #include "network.h"
+#include "passesfiltermodel.h"
+#include "passobject.h"
+#include "passstore.h"
+#include "searchindex.h"
+#include "upnextmodel.h"
 #include "pkpass.h"
 
 // **************************************************************************
@@ -38,22 +46,47 @@
 
 namespace passes {
 struct PassSorter {
-    bool operator()(PassPtr a, PassPtr b) const
+    bool operator()(const PassPtr& a, const PassPtr& b) const
     {
-        return a->sortingDate.toSecsSinceEpoch() > b->sortingDate.toSecsSinceEpoch();
+        return a->sortKey < b->sortKey || (a->sortKey == b->sortKey && a->id < b->id);
     }
 };
 
+// id, serial and barcode keys of imported passes. a batch is checked against its own keys and
+// those of batches that are staged but not committed (and thus not indexed) yet.
+
+struct ImportKeys {
+    QSet<QString> ids;
+    QSet<QString> serials;
+    QSet<QByteArray> barcodes;
+};
+
 template <typename T>
 using ResultCallback = std::function<void(PassResult)>;
 
 class PassesModel : public QAbstractListModel {
-    enum RoleNames { PassRole = Qt::UserRole + 1 };
+    enum RoleNames {
+        PassRole = Qt::UserRole + 1,
+        IdRole,
+        OrganizationRole,
+        DescriptionRole,
+        StyleRole,
+        BackgroundColorRole,
+        ForegroundColorRole,
+        LabelColorRole,
+        ExpiredRole,
+        BundleCountRole,
+        BundlePassesRole
+    };
 
     Q_OBJECT
     Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
     Q_PROPERTY(int countExpired READ getCountExpired NOTIFY countExpiredChanged)
     Q_PROPERTY(QFont defaultFont READ getDefaultFont WRITE setDefaultFont)
+    Q_PROPERTY(int imageCacheSize READ getImageCacheSize WRITE setImageCacheSize)
+    Q_PROPERTY(passes::PassesFilterModel* visiblePasses READ getVisiblePasses CONSTANT)
+    Q_PROPERTY(passes::UpNextModel* upNext READ getUpNext CONSTANT)
+    Q_PROPERTY(bool havePosition READ getHavePosition NOTIFY positionChanged)
 
 public:
     static PassesModel* getInstace()
@@ -63,6 +96,7 @@ public:
 
 public:
     explicit PassesModel(QObject* parent = nullptr);
+    ~PassesModel();
 
     // QAbstractListModel
 
@@ -70,9 +104,9 @@ public:
     int rowCount(const QModelIndex& parent = QModelIndex()) const;
     QHash<int, QByteArray> roleNames() const;
 
-    // QML interaction
+    // QML interaction. file operations run in the pass store, their results arrive as signals.
 
-    Q_INVOKABLE QString init();
+    Q_INVOKABLE void init();
     Q_INVOKABLE void reload();
 
     Q_INVOKABLE void fetchPassUpdates();
@@ -80,46 +114,116 @@ public:
     Q_INVOKABLE void showExpired();
     Q_INVOKABLE void hideExpired();
 
-    Q_INVOKABLE QString importPass(const QString& filePath, bool expiredShown);
-    Q_INVOKABLE QString deleteFile(QString filePath);
-    Q_INVOKABLE QString deletePass(QString id);
+    Q_INVOKABLE void importPass(const QString& filePath);
+    Q_INVOKABLE void importPasses(const QStringList& filePaths);
+    Q_INVOKABLE void deleteFile(const QString& filePath);
+    Q_INVOKABLE void deletePass(const QString& id);
+
+    Q_INVOKABLE void createExportBundle(const QString& bundleId);
 
-    Q_INVOKABLE QVariant createExportBundle(const QString& bundleId);
+    Q_INVOKABLE QVariantMap imageCacheStats();
+
+    Q_INVOKABLE QStringList search(const QString& query) const;
+
+    // the current position is pushed in by whatever position source is available
+
+    Q_INVOKABLE void setPosition(double latitude, double longitude);
+    Q_INVOKABLE void clearPosition();
+    Q_INVOKABLE QStringList nearby() const;
 
     QFont getDefaultFont()
     {
         return QFont();
     }
-    void setDefaultFont(QFont to)
-    {
-        pkpass.setDefaultFont(to);
-    }
+    void setDefaultFont(QFont to);
     int getCountExpired()
     {
         return countExpired;
     }
+    int getImageCacheSize();
+    void setImageCacheSize(int megabytes);
+
+    PassesFilterModel* getVisiblePasses()
+    {
+        return mFilter;
+    }
+    UpNextModel* getUpNext()
+    {
+        return mUpNext;
+    }
 
     PassPtr getPass(QString id)
     {
-        return mItemMap.count(id) ? mItemMap[id] : nullptr;
+        return mItemMap.value(id);
+    }
+    PassObject* getObject(const PassPtr& pass) const;
+
+    static bool isExpired(const PassPtr& pass);
+    bool isExpired(int row) const;
+
+    QString getId(int row) const
+    {
+        return row >= 0 && row < (int)mItems.size() ? mItems[row]->id : QString();
+    }
+    const PassPtr& passAt(int row) const
+    {
+        return mItems[row];
+    }
+    const SearchIndex& getSearchIndex() const
+    {
+        return searchIndex;
     }
+    const LocationIndex& getLocationIndex() const
+    {
+        return locationIndex;
+    }
+    bool getHavePosition() const
+    {
+        return havePosition;
+    }
+    QHash<QString, double> relevantHere() const;
 
 signals:
     void countChanged();
     void countExpiredChanged();
+    void positionChanged();
     void passUpdatesFetched(QString error);
     void failedPasses(QVariantList passes);
 
+    void initialized(QString error);
+    void passesLoaded();
+    void importProgress(int done, int total);
+    void importFinished(int count);
+    void importFailed(QVariantList passes);
+    void passDeleted(QString id, QString filePath, QString error);
+    void fileDeleted(QString filePath, QString error);
+    void bundleExported(QString bundleId, QString filePath, QString error);
+
+private slots:
+    void passExpired(const QString& id);
+
+    void storeInitialized(const QString& error);
+    void storeLoaded(const PassList& passes, const QVariantList& failed);
+    void storeImportStaged(const QString& stagingPath, const PassList& passes,
+                           const QStringList& sources, const QVariantList& failed);
+    void storeImportCommitted(const QString& stagingPath, const PassList& passes,
+                              const QVariantList& failed);
+    void storeFilesRemoved(const QString& id, const QStringList& filePaths, const QString& error);
+    void storeUpdateStored(const QString& id, const PassResult& result);
+
 private:
-    void openPasses(bool openExired);
-    void readPasses(QVariantList& failed, QMap<QString, PassList>& bundles, bool doShowExpired);
-    void addBundlePasses(QMap<QString, PassList>& bundles, bool doShowExpired);
+    void insertPasses(PassList passes);
+    void removePassRows(int first, int last);
+    int findRow(const PassPtr& pass) const;
 
-    void fetchPassUpdate(PassPtr pass, ResultCallback<PassPtr> callback);
+    void addToIndex(const PassPtr& pass);
+    void removeFromIndex(const PassPtr& pass);
+    QString findDuplicate(const PassPtr& pass, const QString& ignoreId = QString()) const;
 
-    PassResult storePassUpdate(PassPtr pass, QByteArray data);
+    void fetchPassUpdate(PassPtr pass, ResultCallback<PassPtr> callback);
 
-    bool isOpen(const QString& filePath);
+    void updateObject(const QString& id, const PassPtr& pass);
+    void releaseObject(const QString& id);
 
     QString getDataPath() const;
 
@@ -127,12 +231,26 @@ private:
 
     bool storageReady;
     int countExpired;
-    Pkpass pkpass;
+    bool havePosition;
+    double latitude;
+    double longitude;
     PassSorter passSorter;
 
+    QThread storeThread;
+    PassStore* store;
+    QHash<QString, ResultCallback<PassPtr>> pendingUpdates; // pass id -> update callback
+    QHash<QString, ImportKeys> pendingImports;               // staging path -> staged keys
+
     PassList mItems;
-    PassMap mItemMap;
-    QDir passesDir;
+    PassMap mItemMap;                           // id -> pass
+    QMultiHash<QByteArray, QString> mBarcodeIndex; // barcode message hash -> ids
+    QMultiHash<QString, QString> mSerialIndex;     // pass type identifier + serial number -> ids
+    mutable QHash<QString, PassObject*> mObjects;
+    PassesFilterModel* mFilter;
+    UpNextModel* mUpNext;
+    ExpiryScheduler expiry;
+    SearchIndex searchIndex;
+    LocationIndex locationIndex;
 
     network::Network net;
 };
@@ -22,45 +22,137 @@
 // **************************************************************************
 
 #include "passimageprovider.h"
+#include "barcode.h"
+#include "blur.h"
+#include "imagecache.h"
 #include "passesmodel.h"
+#include "texturecache.h"
+#include "thumbnailcache.h"
 
 #include <QDebug>
+#include <QThread>
 
 // **************************************************************************
 // class PassImageProvider
 // **************************************************************************
 
 namespace passes {
-QImage PassImageProvider::requestImage(const QString& id, QSize* /*size*/,
-                                       const QSize& /*requestedSize*/)
+PassImageProvider::PassImageProvider()
+{
+    // decoding and barcode rendering must not queue up behind each other, but also shouldn't
+    // compete with the GUI and render threads for all cores
+
+    pool.setMaxThreadCount(qBound(1, QThread::idealThreadCount() - 1, 4));
+}
+
+PassImageProvider::~PassImageProvider()
+{
+    pool.clear();
+    pool.waitForDone();
+}
+
+// **************************************************************************
+// requestImageResponse
+// **************************************************************************
+
+QQuickImageResponse* PassImageProvider::requestImageResponse(const QString& id,
+                                                             const QSize& requestedSize)
+{
+    QString key = id + "@" + QString::number(requestedSize.width()) + "x"
+                  + QString::number(requestedSize.height());
+
+    bool start = false;
+    PassImageResponse* response = nullptr;
+
+    {
+        QMutexLocker lock(&mutex);
+
+        // the response is attached in the same section, so a finishing job can't miss it
+
+        ImageJobPtr job = jobs.value(key);
+
+        if (!job) {
+            job = std::make_shared<ImageJob>();
+            job->key = key;
+            job->id = id;
+            job->requestedSize = requestedSize;
+
+            jobs.insert(key, job);
+            start = true;
+        }
+
+        response = new PassImageResponse(this, job);
+        job->waiters.append(response);
+
+        if (start) {
+            // requests come in on the pixmap reader thread. the pass is looked up on the GUI
+            // thread, which owns the model, and the job gets a copy of its image sources.
+
+            QMetaObject::invokeMethod(
+              &guiContext,
+              [this, job]() {
+                  resolve(job);
+                  pool.start(new ImageJobRunner(this, job));
+              },
+              Qt::QueuedConnection);
+        }
+    }
+
+    return response;
+}
+
+// **************************************************************************
+// resolve
+// **************************************************************************
+
+void PassImageProvider::resolve(const ImageJobPtr& job)
 {
     PassesModel* model = PassesModel::getInstace();
 
     if (!model)
-        return QImage();
+        return;
 
-    QStringList comps = id.split("/");
+    QStringList comps = job->id.split("/");
 
     if (comps.size() < 2)
-        return QImage();
+        return;
 
     PassPtr pass = model->getPass(comps[0]);
 
-    if (!pass)
-        return QImage();
+    if (!pass) {
+        job->error = "Unknown pass " + comps[0];
+        return;
+    }
+
+    const PassImage* image = nullptr;
 
     if (comps[1] == "background")
-        return pass->imgBackground;
-    if (comps[1] == "footer")
-        return pass->imgFooter;
-    if (comps[1] == "icon")
-        return pass->imgIcon;
-    if (comps[1] == "logo")
-        return pass->imgLogo;
-    if (comps[1] == "strip")
-        return pass->imgStrip;
-    if (comps[1] == "thumbnail")
-        return pass->imgThumbnail;
+        image = &pass->imgBackground;
+    else if (comps[1] == "footer")
+        image = &pass->imgFooter;
+    else if (comps[1] == "icon")
+        image = &pass->imgIcon;
+    else if (comps[1] == "logo")
+        image = &pass->imgLogo;
+    else if (comps[1] == "strip")
+        image = &pass->imgStrip;
+    else if (comps[1] == "thumbnail")
+        image = &pass->imgThumbnail;
+
+    if (image) {
+        job->image = *image;
+
+        if (comps.size() >= 3 && comps[2] == "blurred") {
+            job->kind = ImageJob::Blurred;
+            job->cornerRadius = comps.size() >= 4 ? comps[3].toInt() : 0;
+        }
+        else if (comps.size() >= 3 && comps[2] == "card")
+            job->kind = ImageJob::Card;
+        else
+            job->kind = ImageJob::Image;
+
+        return;
+    }
 
     if (comps[1] == "barcode") {
         int index = 0;
@@ -75,12 +167,157 @@ QImage PassImageProvider::requestImage(const QString& id, QSize* /*size*/,
             pass = pass->bundlePasses[bundleIndex];
 
         if (index < 0 || index >= pass->standard.barcodes.size())
-            return QImage();
+            return;
+
+        job->barcode = pass->standard.barcodes[index];
+        job->kind = ImageJob::BarcodeImage;
+    }
+}
+
+// **************************************************************************
+// run
+// **************************************************************************
+
+void PassImageProvider::run(const ImageJobPtr& job)
+{
+    {
+        QMutexLocker lock(&mutex);
+
+        if (job->cancelled)
+            return;
+    }
 
-        return pass->standard.barcodes[index].image;
+    QString error;
+    QImage image = loadImage(job, &error);
+    QList<PassImageResponse*> waiters;
+
+    {
+        QMutexLocker lock(&mutex);
+
+        if (jobs.value(job->key) == job)
+            jobs.remove(job->key);
+
+        waiters.swap(job->waiters);
     }
 
+    // responses handed out here can't be deleted before they have seen their finished() signal,
+    // so they are safe to use outside of the lock
+
+    for (auto response : waiters)
+        response->deliver(image, error);
+}
+
+// **************************************************************************
+// detach
+// **************************************************************************
+
+bool PassImageProvider::detach(PassImageResponse* response, const ImageJobPtr& job)
+{
+    QMutexLocker lock(&mutex);
+
+    if (!job->waiters.removeOne(response))
+        return false;
+
+    // last one waiting for this image (e.g. delegate destroyed while scrolling), drop the job
+    // so it is skipped if not yet started, and a new request doesn't attach to it
+
+    if (job->waiters.isEmpty()) {
+        job->cancelled = true;
+
+        if (jobs.value(job->key) == job)
+            jobs.remove(job->key);
+    }
+
+    return true;
+}
+
+// **************************************************************************
+// loadImage
+// **************************************************************************
+
+// runs on the pool threads and only reads what resolve() copied into the job
+
+QImage PassImageProvider::loadImage(const ImageJobPtr& job, QString* error)
+{
+    switch (job->kind) {
+        case ImageJob::Blurred:
+            // eventTicket backgrounds are shown blurred. the blur is computed once from the
+            // smallest variant and cached by image hash, the cards rounded corners are cut out at
+            // the requested size, so the image can be drawn without a mask layer
+
+            return blur::blurredBackground(job->image.isNull() ? ImageHandle()
+                                                               : job->image.variants.first(),
+                                           job->requestedSize, job->cornerRadius);
+
+        case ImageJob::Card: {
+            // collapsed cards only use the pre-scaled copies from the thumbnail cache, full
+            // images are decoded once a card is opened
+
+            QSize scaledSize;
+            auto handle = job->image.pick(devicePixelRatio, job->requestedSize, &scaledSize);
+
+            return ThumbnailCache::instance()->get(handle, scaledSize);
+        }
+
+        case ImageJob::Image:
+            return job->image.decode(devicePixelRatio, job->requestedSize);
+
+        case ImageJob::BarcodeImage: {
+            const Barcode& barcode = job->barcode;
+            QImage image = ImageCache::instance()->find(barcode.cacheKey());
+
+            if (image.isNull()) {
+                *error = BarcodeGenerator::generate(barcode.message, barcode.format,
+                                                    barcode.encoding, &image);
+
+                ImageCache::instance()->insert(barcode.cacheKey(), image);
+            }
+
+            return image;
+        }
+
+        case ImageJob::None:
+            break;
+    }
+
+    *error = job->error;
     return QImage();
 }
 
+// **************************************************************************
+// class PassImageResponse
+// **************************************************************************
+
+QQuickTextureFactory* PassImageResponse::textureFactory() const
+{
+    if (image.isNull())
+        return nullptr;
+
+    // passes with identical image files get the same decoded image from the image store. keying
+    // by its pixel data lets all of their delegates share one uploaded texture.
+
+    return new SharedTextureFactory(QString::number(image.cacheKey()), image);
+}
+
+QString PassImageResponse::errorString() const
+{
+    return error;
+}
+
+void PassImageResponse::cancel()
+{
+    // only finish here if the job didn't already pick us up for delivery
+
+    if (provider->detach(this, job))
+        emit finished();
+}
+
+void PassImageResponse::deliver(const QImage& result, const QString& err)
+{
+    image = result;
+    error = err;
+
+    emit finished();
+}
+
 } // namespace passes
@@ -22,7 +22,17 @@
 #ifndef PASSIMAGEPROVIDER_H
 #define PASSIMAGEPROVIDER_H
 
+#include <QHash>
+#include <QList>
+#include <QMutex>
 #include <QQuickImageProvider>
+#include <QRunnable>
+#include <QThreadPool>
+
+#include <atomic>
+#include <memory>
+
+#include "pkpass.h"
 
 // **************************************************************************
 // class PassImageProvider
@@ -30,17 +40,105 @@
 
 namespace passes
 {
-   class PassImageProvider : public QQuickImageProvider
+   class PassImageProvider;
+   class PassImageResponse;
+
+   // one load of an image, shared by all responses requesting the same id & size while it is in
+   // flight. waiters and cancelled are guarded by the providers mutex. the source fields are
+   // filled on the GUI thread before the job is started and only read by the pool thread.
+
+   struct ImageJob
+   {
+      enum Kind { None, Image, Card, Blurred, BarcodeImage };
+
+      QString key;
+      QString id;
+      QSize requestedSize;
+      QList<PassImageResponse*> waiters;
+      bool cancelled = false;
+
+      Kind kind = None;
+      PassImage image;
+      int cornerRadius = 0;
+      Barcode barcode;
+      QString error;
+   };
+
+   using ImageJobPtr = std::shared_ptr<ImageJob>;
+
+   // **************************************************************************
+   // class PassImageResponse
+   // **************************************************************************
+
+   class PassImageResponse : public QQuickImageResponse
    {
       public:
-         PassImageProvider()
-            : QQuickImageProvider(QQuickImageProvider::Image) {}
+         PassImageResponse(PassImageProvider* provider, ImageJobPtr job)
+            : provider(provider), job(std::move(job)) {}
+
+         QQuickTextureFactory* textureFactory() const override;
+         QString errorString() const override;
+         void cancel() override;
 
-         QImage requestImage(const QString &id, QSize *size, const QSize &requestedSize) override;
+         void deliver(const QImage& result, const QString& err);
+
+      private:
+         PassImageProvider* provider;
+         ImageJobPtr job;
+         QImage image;
+         QString error;
    };
 
-} // namespace passes
+   // **************************************************************************
+   // class PassImageProvider
+   // **************************************************************************
 
+   class PassImageProvider : public QQuickAsyncImageProvider
+   {
+      public:
+         PassImageProvider();
+         ~PassImageProvider() override;
 
+         QQuickImageResponse* requestImageResponse(const QString& id, const QSize& requestedSize) override;
+
+         // only used for images requested without a size. sized requests already carry the
+         // screens pixel ratio.
+
+         void setDevicePixelRatio(qreal ratio) { devicePixelRatio = ratio; }
+
+      private:
+         friend class PassImageResponse;
+         friend class ImageJobRunner;
+
+         void resolve(const ImageJobPtr& job);
+         QImage loadImage(const ImageJobPtr& job, QString* error);
+         bool detach(PassImageResponse* response, const ImageJobPtr& job);
+         void run(const ImageJobPtr& job);
+
+         std::atomic<qreal> devicePixelRatio { 1.0 };
+         QThreadPool pool;
+         QObject guiContext; // lives on the GUI thread, where the model may be read
+         QMutex mutex;
+         QHash<QString, ImageJobPtr> jobs;
+   };
+
+   // **************************************************************************
+   // class ImageJobRunner
+   // **************************************************************************
+
+   class ImageJobRunner : public QRunnable
+   {
+      public:
+         ImageJobRunner(PassImageProvider* provider, ImageJobPtr job)
+            : provider(provider), job(std::move(job)) {}
+
+         void run() override { provider->run(job); }
+
+      private:
+         PassImageProvider* provider;
+         ImageJobPtr job;
+   };
+
+} // namespace passes
 
 #endif // PASSIMAGEPROVIDER_H
@@ -0,0 +1,228 @@
+// **************************************************************************
+// class PassObject
+// 19.10.2026
+// QML facing wrapper around a shared pass
+// **************************************************************************
+// MIT License
+// Copyright © 2021 Patrick Fial
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions: The above copyright notice and this
+// permission notice shall be included in all copies or substantial portions of the Software. THE
+// SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+// LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// **************************************************************************
+// includes
+// **************************************************************************
+
+#include "passobject.h"
+
+namespace passes {
+// **************************************************************************
+// class PassObject
+// **************************************************************************
+
+PassObject::PassObject(PassPtr pass, QObject* parent)
+  : QObject(parent),
+    pass(pass),
+    standard(pass, this),
+    details(pass, this),
+    headerFields(true, this),
+    primaryFields(false, this),
+    secondaryFields(false, this),
+    auxiliaryFields(false, this),
+    backFields(false, this),
+    bundlePasses(new BundleModel(this))
+{
+    updateModels();
+}
+
+// **************************************************************************
+// setPass
+// **************************************************************************
+
+void PassObject::setPass(PassPtr to)
+{
+    if (!to || to == pass)
+        return;
+
+    pass = to;
+
+    updateModels();
+    emit passChanged();
+}
+
+// **************************************************************************
+// refresh
+// **************************************************************************
+
+// to be called after the pass was modified in place
+
+void PassObject::refresh()
+{
+    standard.refresh();
+    bundlePasses->refresh();
+    emit passChanged();
+}
+
+// **************************************************************************
+// updateModels
+// **************************************************************************
+
+void PassObject::updateModels()
+{
+    standard.setPass(pass);
+    details.setPass(pass);
+    headerFields.setFields(pass->details.headerFields);
+    primaryFields.setFields(pass->details.primaryFields);
+    secondaryFields.setFields(pass->details.secondaryFields);
+    auxiliaryFields.setFields(pass->details.auxiliaryFields);
+    backFields.setFields(pass->details.backFields);
+    bundlePasses->setPasses(pass->bundlePasses);
+}
+
+// **************************************************************************
+// class StandardObject
+// **************************************************************************
+
+StandardObject::StandardObject(PassPtr pass, QObject* parent) : QObject(parent), pass(pass)
+{
+    refresh();
+}
+
+void StandardObject::setPass(PassPtr to)
+{
+    if (!to || to == pass)
+        return;
+
+    pass = to;
+    refresh();
+}
+
+// the lists are rebuilt here only, reading them hands out the shared copies
+
+void StandardObject::refresh()
+{
+    barcodes = toVariantList(pass->standard.barcodes);
+    locations = toVariantList(pass->standard.locations);
+    beacons = toVariantList(pass->standard.beacons);
+
+    emit changed();
+}
+
+// **************************************************************************
+// class DetailsObject
+// **************************************************************************
+
+DetailsObject::DetailsObject(PassPtr pass, QObject* parent) : QObject(parent), pass(pass) {}
+
+void DetailsObject::setPass(PassPtr to)
+{
+    if (!to || to == pass)
+        return;
+
+    pass = to;
+    emit changed();
+}
+
+// **************************************************************************
+// class BundleModel
+// **************************************************************************
+
+BundleModel::BundleModel(QObject* parent) : QAbstractListModel(parent) {}
+
+// **************************************************************************
+// data
+// **************************************************************************
+
+QVariant BundleModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= mItems.size())
+        return QVariant();
+
+    if (role == Qt::DisplayRole || role == PassRole)
+        return QVariant::fromValue(mItems[index.row()]);
+
+    return QVariant();
+}
+
+// **************************************************************************
+// rowCount
+// **************************************************************************
+
+int BundleModel::rowCount(const QModelIndex& /*parent*/) const
+{
+    return mItems.size();
+}
+
+// **************************************************************************
+// roleNames
+// **************************************************************************
+
+QHash<int, QByteArray> BundleModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[PassRole] = "pass";
+    return roles;
+}
+
+// **************************************************************************
+// get
+// **************************************************************************
+
+PassObject* BundleModel::get(int row) const
+{
+    return row >= 0 && row < mItems.size() ? mItems[row] : nullptr;
+}
+
+// **************************************************************************
+// refresh
+// **************************************************************************
+
+void BundleModel::refresh()
+{
+    for (auto object : mItems)
+        object->refresh();
+}
+
+// **************************************************************************
+// setPasses
+// **************************************************************************
+
+// members that are still there keep their objects (and with that their delegates), only the
+// pass inside is swapped
+
+void BundleModel::setPasses(const PassList& passes)
+{
+    int count = passes.size();
+    int common = qMin(mItems.size(), count);
+
+    for (int i = 0; i < common; i++)
+        mItems[i]->setPass(passes[i]);
+
+    if (count > mItems.size()) {
+        beginInsertRows(QModelIndex(), mItems.size(), count - 1);
+
+        for (int i = mItems.size(); i < count; i++)
+            mItems << new PassObject(passes[i], this);
+
+        endInsertRows();
+        emit countChanged();
+    } else if (count < mItems.size()) {
+        beginRemoveRows(QModelIndex(), count, mItems.size() - 1);
+
+        while (mItems.size() > count)
+            mItems.takeLast()->deleteLater();
+
+        endRemoveRows();
+        emit countChanged();
+    }
+}
+
+} // namespace passes
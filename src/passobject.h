@@ -0,0 +1,369 @@
+// **************************************************************************
+// class PassObject
+// 19.10.2026
+// QML facing wrapper around a shared pass
+// **************************************************************************
+// MIT License
+// Copyright © 2021 Patrick Fial
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions: The above copyright notice and this
+// permission notice shall be included in all copies or substantial portions of the Software. THE
+// SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+// LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// **************************************************************************
+// includes
+// **************************************************************************
+
+#ifndef PASSOBJECT_H
+#define PASSOBJECT_H
+
+#include <QAbstractListModel>
+#include <QObject>
+
+#include "fieldsmodel.h"
+#include "pkpass.h"
+
+// **************************************************************************
+// class PassObject
+// **************************************************************************
+
+// exposes a pass to QML with typed properties. the object does not copy anything, all reads go
+// to the shared pass, which can be swapped when the pass is updated.
+
+namespace passes {
+class BundleModel;
+
+// **************************************************************************
+// class StandardObject
+// **************************************************************************
+
+// the standard keys of a pass. reads go to the shared pass, only the lists of gadgets are built
+// once per pass instead of on every read.
+
+class StandardObject : public QObject {
+    Q_OBJECT
+    Q_PROPERTY(QString description READ getDescription NOTIFY changed)
+    Q_PROPERTY(QString organization READ getOrganization NOTIFY changed)
+    Q_PROPERTY(QString passTypeIdentifier READ getPassTypeIdentifier NOTIFY changed)
+    Q_PROPERTY(QString serialNumber READ getSerialNumber NOTIFY changed)
+    Q_PROPERTY(QString expirationDate READ getExpirationDate NOTIFY changed)
+    Q_PROPERTY(QString relevantDate READ getRelevantDate NOTIFY changed)
+    Q_PROPERTY(bool voided READ getVoided NOTIFY changed)
+    Q_PROPERTY(bool expired READ getExpired NOTIFY changed)
+    Q_PROPERTY(int maxDistance READ getMaxDistance NOTIFY changed)
+    Q_PROPERTY(QString backgroundColor READ getBackgroundColor NOTIFY changed)
+    Q_PROPERTY(QString foregroundColor READ getForegroundColor NOTIFY changed)
+    Q_PROPERTY(QString labelColor READ getLabelColor NOTIFY changed)
+    Q_PROPERTY(QString logoText READ getLogoText NOTIFY changed)
+    Q_PROPERTY(QString barcodeFormat READ getBarcodeFormat NOTIFY changed)
+    Q_PROPERTY(QString stripExtraForegroundColor READ getStripExtraForegroundColor NOTIFY changed)
+    Q_PROPERTY(QString stripExtraLabelColor READ getStripExtraLabelColor NOTIFY changed)
+    Q_PROPERTY(QVariantList barcodes READ getBarcodes NOTIFY changed)
+    Q_PROPERTY(QVariantList locations READ getLocations NOTIFY changed)
+    Q_PROPERTY(QVariantList beacons READ getBeacons NOTIFY changed)
+
+public:
+    StandardObject(PassPtr pass, QObject* parent);
+
+    void setPass(PassPtr to);
+    void refresh();
+
+    QString getDescription() const
+    {
+        return pass->standard.description;
+    }
+    QString getOrganization() const
+    {
+        return pass->standard.organization;
+    }
+    QString getPassTypeIdentifier() const
+    {
+        return pass->standard.passTypeIdentifier;
+    }
+    QString getSerialNumber() const
+    {
+        return pass->standard.serialNumber;
+    }
+    QString getExpirationDate() const
+    {
+        return pass->standard.expirationDate;
+    }
+    QString getRelevantDate() const
+    {
+        return pass->standard.relevantDate;
+    }
+    bool getVoided() const
+    {
+        return pass->standard.voided;
+    }
+    bool getExpired() const
+    {
+        return pass->standard.expired;
+    }
+    int getMaxDistance() const
+    {
+        return pass->standard.maxDistance;
+    }
+    QString getBackgroundColor() const
+    {
+        return pass->standard.backgroundColor;
+    }
+    QString getForegroundColor() const
+    {
+        return pass->standard.foregroundColor;
+    }
+    QString getLabelColor() const
+    {
+        return pass->standard.labelColor;
+    }
+    QString getLogoText() const
+    {
+        return pass->standard.logoText;
+    }
+    QString getBarcodeFormat() const
+    {
+        return pass->standard.barcodeFormat;
+    }
+    QString getStripExtraForegroundColor() const
+    {
+        return pass->standard.stripExtraForegroundColor;
+    }
+    QString getStripExtraLabelColor() const
+    {
+        return pass->standard.stripExtraLabelColor;
+    }
+    QVariantList getBarcodes() const
+    {
+        return barcodes;
+    }
+    QVariantList getLocations() const
+    {
+        return locations;
+    }
+    QVariantList getBeacons() const
+    {
+        return beacons;
+    }
+
+signals:
+    void changed();
+
+private:
+    PassPtr pass;
+    QVariantList barcodes;
+    QVariantList locations;
+    QVariantList beacons;
+};
+
+// **************************************************************************
+// class DetailsObject
+// **************************************************************************
+
+// the style of a pass. its fields are listed by the FieldsModels of PassObject.
+
+class DetailsObject : public QObject {
+    Q_OBJECT
+    Q_PROPERTY(QString style READ getStyle NOTIFY changed)
+    Q_PROPERTY(QString transitType READ getTransitType NOTIFY changed)
+    Q_PROPERTY(qreal maxFieldLabelWidth READ getMaxFieldLabelWidth NOTIFY changed)
+
+public:
+    DetailsObject(PassPtr pass, QObject* parent);
+
+    void setPass(PassPtr to);
+
+    QString getStyle() const
+    {
+        return pass->details.style;
+    }
+    QString getTransitType() const
+    {
+        return pass->details.transitType;
+    }
+    qreal getMaxFieldLabelWidth() const
+    {
+        return pass->details.maxFieldLabelWidth;
+    }
+
+signals:
+    void changed();
+
+private:
+    PassPtr pass;
+};
+
+
+class PassObject : public QObject {
+    Q_OBJECT
+    Q_PROPERTY(QString id READ getId NOTIFY passChanged)
+    Q_PROPERTY(QDateTime modified READ getModified NOTIFY passChanged)
+    Q_PROPERTY(QString filePath READ getFilePath NOTIFY passChanged)
+    Q_PROPERTY(QString bundleName READ getBundleName NOTIFY passChanged)
+    Q_PROPERTY(bool bundleExpired READ getBundleExpired NOTIFY passChanged)
+    Q_PROPERTY(int bundleIndex READ getBundleIndex NOTIFY passChanged)
+    Q_PROPERTY(QString bundleId READ getBundleId NOTIFY passChanged)
+    Q_PROPERTY(passes::BundleModel* bundlePasses READ getBundlePasses CONSTANT)
+    Q_PROPERTY(passes::StandardObject* standard READ getStandard CONSTANT)
+    Q_PROPERTY(passes::DetailsObject* details READ getDetails CONSTANT)
+    Q_PROPERTY(passes::WebService webservice READ getWebservice NOTIFY passChanged)
+    Q_PROPERTY(QString updateError READ getUpdateError NOTIFY passChanged)
+    Q_PROPERTY(bool haveStripImage READ getHaveStripImage NOTIFY passChanged)
+    Q_PROPERTY(bool haveBackgroundImage READ getHaveBackgroundImage NOTIFY passChanged)
+    Q_PROPERTY(passes::FieldsModel* headerFields READ getHeaderFields CONSTANT)
+    Q_PROPERTY(passes::FieldsModel* primaryFields READ getPrimaryFields CONSTANT)
+    Q_PROPERTY(passes::FieldsModel* secondaryFields READ getSecondaryFields CONSTANT)
+    Q_PROPERTY(passes::FieldsModel* auxiliaryFields READ getAuxiliaryFields CONSTANT)
+    Q_PROPERTY(passes::FieldsModel* backFields READ getBackFields CONSTANT)
+
+public:
+    explicit PassObject(PassPtr pass, QObject* parent = nullptr);
+
+    const PassPtr& getPass() const
+    {
+        return pass;
+    }
+    void setPass(PassPtr to);
+    void refresh();
+
+    QString getId() const
+    {
+        return pass->id;
+    }
+    QDateTime getModified() const
+    {
+        return pass->modified;
+    }
+    QString getFilePath() const
+    {
+        return pass->filePath;
+    }
+    QString getBundleName() const
+    {
+        return pass->bundleName;
+    }
+    bool getBundleExpired() const
+    {
+        return pass->bundleExpired;
+    }
+    int getBundleIndex() const
+    {
+        return pass->bundleIndex;
+    }
+    QString getBundleId() const
+    {
+        return pass->bundleId;
+    }
+    StandardObject* getStandard()
+    {
+        return &standard;
+    }
+    DetailsObject* getDetails()
+    {
+        return &details;
+    }
+    WebService getWebservice() const
+    {
+        return pass->webservice;
+    }
+    QString getUpdateError() const
+    {
+        return pass->updateError;
+    }
+    bool getHaveStripImage() const
+    {
+        return pass->haveStripImage;
+    }
+    bool getHaveBackgroundImage() const
+    {
+        return pass->haveBackgroundImage;
+    }
+
+    // header fields are listed right to left, the model holds them in display order
+
+    FieldsModel* getHeaderFields()
+    {
+        return &headerFields;
+    }
+    FieldsModel* getPrimaryFields()
+    {
+        return &primaryFields;
+    }
+    FieldsModel* getSecondaryFields()
+    {
+        return &secondaryFields;
+    }
+    FieldsModel* getAuxiliaryFields()
+    {
+        return &auxiliaryFields;
+    }
+    FieldsModel* getBackFields()
+    {
+        return &backFields;
+    }
+    BundleModel* getBundlePasses()
+    {
+        return bundlePasses;
+    }
+
+signals:
+    void passChanged();
+
+private:
+    void updateModels();
+
+    PassPtr pass;
+    StandardObject standard;
+    DetailsObject details;
+    FieldsModel headerFields;
+    FieldsModel primaryFields;
+    FieldsModel secondaryFields;
+    FieldsModel auxiliaryFields;
+    FieldsModel backFields;
+    BundleModel* bundlePasses;
+};
+
+// **************************************************************************
+// class BundleModel
+// **************************************************************************
+
+// the passes of a bundle, one PassObject per member
+
+class BundleModel : public QAbstractListModel {
+    enum RoleNames { PassRole = Qt::UserRole + 1 };
+
+    Q_OBJECT
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+
+public:
+    explicit BundleModel(QObject* parent = nullptr);
+
+    // QAbstractListModel
+
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const;
+    QHash<int, QByteArray> roleNames() const;
+
+    // QML interaction
+
+    Q_INVOKABLE passes::PassObject* get(int row) const;
+
+    void setPasses(const PassList& passes);
+    void refresh();
+
+signals:
+    void countChanged();
+
+private:
+    QList<PassObject*> mItems;
+};
+
+} // namespace passes
+
+#endif // PASSOBJECT_H
@@ -0,0 +1,681 @@
+// **************************************************************************
+// class PassStore
+// 19.10.2026
+// Owner of the passes directory, runs all pass file I/O on a worker thread
+// **************************************************************************
+// MIT License
+// Copyright © 2021 Patrick Fial
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions: The above copyright notice and this
+// permission notice shall be included in all copies or substantial portions of the Software. THE
+// SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+// LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// **************************************************************************
+// includes
+// **************************************************************************
+
+#include "passstore.h"
+#include <QAtomicInt>
+#include <QBuffer>
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QSet>
+#include <QThreadPool>
+
+#include "thumbnailcache.h"
+#include <algorithm>
+#include "quazip/quazipfile.h"
+
+namespace C {
+#include <libintl.h>
+}
+
+namespace passes {
+// **************************************************************************
+// class PassStore
+// **************************************************************************
+
+PassStore::PassStore(QObject* parent) : QObject(parent), storageReady(false), importCount(0)
+{
+    qRegisterMetaType<PassList>();
+    qRegisterMetaType<PassResult>();
+}
+
+// **************************************************************************
+// init
+// **************************************************************************
+
+void PassStore::init(const QString& dataPath)
+{
+    if (!dataPath.size()) {
+        emit initialized(C::gettext("Failed to determine writable app data storage location"));
+        return;
+    }
+
+    QDir dir(dataPath + "/passes");
+
+    if (!dir.exists()) {
+        bool res = dir.mkpath(dataPath + "/passes");
+
+        if (!res) {
+            emit initialized(QString(C::gettext("App data storage location inaccessible")) + " ("
+                             + QString(C::gettext("can't create subfolder:")) + " "
+                             + dir.absolutePath() + ")");
+            return;
+        }
+    }
+
+    passesDir.setPath(dir.path());
+    passesDir.setSorting(QDir::Time);
+    storageReady = true;
+
+    emit initialized("");
+}
+
+// **************************************************************************
+// setDefaultFont
+// **************************************************************************
+
+void PassStore::setDefaultFont(const QFont& font)
+{
+    pkpass.setDefaultFont(font);
+}
+
+// **************************************************************************
+// makeBundlePass
+// **************************************************************************
+
+static PassPtr makeBundlePass(QString bundleName, PassList& bundlePasses)
+{
+    int idx = 0;
+    auto bundlePass = std::make_shared<Pass>();
+    bundlePass->id = "";
+    bundlePass->bundleName = bundleName;
+    bundlePass->bundleExpired = true;
+    bundlePass->bundlePasses = std::move(bundlePasses);
+
+    for (auto pass : bundlePass->bundlePasses) {
+        if (bundlePass->id == "")
+            bundlePass->id = pass->id;
+        else
+            pass->bundleId = bundlePass->id;
+
+        if (!pass->standard.expired)
+            bundlePass->bundleExpired = false;
+
+        if (!bundlePass->modified.isValid() || bundlePass->modified.secsTo(pass->modified)) {
+            bundlePass->modified = pass->modified;
+        }
+
+        if (!bundlePass->sortingDate.isValid()
+            || bundlePass->sortingDate.secsTo(pass->sortingDate)) {
+            bundlePass->sortingDate = pass->sortingDate;
+        }
+
+        pass->bundleIndex = idx++;
+    }
+
+    bundlePass->updateSortKeys();
+
+    return bundlePass;
+}
+
+// **************************************************************************
+// readPasses
+// **************************************************************************
+
+void PassStore::readPasses(PassList& found, QVariantList& failed, QMap<QString, PassList>& bundles)
+{
+    for (const QFileInfo& info : passesDir.entryInfoList(QDir::Files | QDir::NoSymLinks
+                                                         | QDir::NoDotAndDotDot | QDir::Readable)) {
+        if (info.fileName().startsWith(".")
+            || (!info.fileName().endsWith(".pkpass") && !info.fileName().endsWith(".pkpasses")))
+            continue;
+
+        if (info.fileName().endsWith(".pkpasses")) {
+            auto bundleResult = pkpass.openBundle(info);
+
+            if (QString* err = std::get_if<QString>(&bundleResult)) {
+                qDebug() << "Bundle open failed: " << *err;
+
+                QVariantMap failedPass;
+                failedPass["filePath"] = info.absoluteFilePath();
+                failedPass["error"] = *err;
+                failed.append(failedPass);
+            } else {
+                found.push_back(makeBundlePass(info.baseName(), std::get<PassList>(bundleResult)));
+            }
+
+            continue;
+        }
+
+        auto passResult = pkpass.openPass(info.absoluteFilePath());
+
+        if (QString* err = std::get_if<QString>(&passResult)) {
+            qDebug() << "Pass open failed: " << *err;
+
+            QVariantMap failedPass;
+            failedPass["filePath"] = info.absoluteFilePath();
+            failedPass["error"] = *err;
+            failed.append(failedPass);
+        } else {
+            auto pass = std::get<PassPtr>(passResult);
+
+            if (!pass->bundleName.isEmpty()) {
+                if (!bundles.contains(pass->bundleName)) {
+                    bundles[pass->bundleName] = PassList {pass};
+                } else {
+                    bundles[pass->bundleName].push_back(pass);
+                }
+            } else {
+                found.push_back(pass);
+            }
+        }
+    }
+}
+
+// **************************************************************************
+// addBundlePasses
+// **************************************************************************
+
+void PassStore::addBundlePasses(PassList& found, QMap<QString, PassList>& bundles)
+{
+    for (auto bundleName : bundles.keys()) {
+        found.push_back(makeBundlePass(bundleName, bundles[bundleName]));
+    }
+}
+
+// **************************************************************************
+// writeBundle
+// **************************************************************************
+
+// the archive is built in memory and replaces the file in one go
+
+static QString writeBundle(const QString& filePath,
+                           const QList<QPair<QString, QByteArray>>& members)
+{
+    QBuffer buffer;
+    QuaZip archive(&buffer);
+
+    if (!archive.open(QuaZip::mdCreate))
+        return QString(C::gettext("Failed to create archive (%1)")).arg(archive.getZipError());
+
+    for (const auto& member : members) {
+        QuaZipNewInfo info(member.first);
+        info.setPermissions(QFileDevice::ReadOwner | QFileDevice::WriteOwner
+                            | QFileDevice::WriteUser | QFileDevice::ReadUser
+                            | QFileDevice::ReadGroup | QFileDevice::ReadOther);
+
+        QuaZipFile zipFile(&archive);
+
+        if (!zipFile.open(QIODevice::WriteOnly, info)) {
+            archive.close();
+            return QString(C::gettext("Failed to add file to archive (%1)"))
+              .arg(archive.getZipError());
+        }
+
+        auto written = zipFile.write(member.second);
+        zipFile.close();
+
+        if (written < member.second.size()) {
+            archive.close();
+            return QString(C::gettext("Failed to add file to archive (%1)"))
+              .arg(zipFile.errorString());
+        }
+    }
+
+    archive.close();
+
+    QSaveFile bundleFile(filePath);
+
+    if (!bundleFile.open(QIODevice::WriteOnly) || bundleFile.write(buffer.data()) < buffer.size()
+        || !bundleFile.commit())
+        return bundleFile.errorString();
+
+    return QString();
+}
+
+// **************************************************************************
+// packLegacyBundles
+// **************************************************************************
+
+// older versions extracted bundles into BUNDLE_<name>_BUNDLE_<file> copies. these are packed back
+// into <name>.pkpasses once. if that fails, the copies stay and are read as before.
+
+void PassStore::packLegacyBundles()
+{
+    QMap<QString, QFileInfoList> legacyBundles;
+
+    for (const QFileInfo& info : passesDir.entryInfoList({ "BUNDLE_*_BUNDLE_*.pkpass" },
+                                                         QDir::Files | QDir::NoSymLinks
+                                                           | QDir::NoDotAndDotDot
+                                                           | QDir::Readable)) {
+        int endIdx = info.fileName().indexOf("_BUNDLE_", 7);
+        legacyBundles[info.fileName().mid(7, endIdx - 7)] << info;
+    }
+
+    for (auto it = legacyBundles.cbegin(); it != legacyBundles.cend(); ++it) {
+        auto passBundlePrefix = "BUNDLE_" + it.key() + "_BUNDLE_";
+        auto targetPath = passesDir.filePath(it.key() + ".pkpasses");
+        QList<QPair<QString, QByteArray>> members;
+
+        if (QFile::exists(targetPath))
+            continue;
+
+        for (const auto& info : it.value()) {
+            QFile passFile(info.absoluteFilePath());
+
+            if (!passFile.open(QIODevice::ReadOnly))
+                break;
+
+            members << qMakePair(info.fileName().mid(passBundlePrefix.size()), passFile.readAll());
+        }
+
+        if (members.size() < it.value().size())
+            continue;
+
+        auto err = writeBundle(targetPath, members);
+
+        if (!err.isEmpty()) {
+            qDebug() << "Failed to pack legacy bundle " << it.key() << ": " << err;
+            continue;
+        }
+
+        for (const auto& info : it.value()) {
+            if (!QFile::remove(info.absoluteFilePath()))
+                qDebug() << "Failed to delete packed bundle pass " << info.absoluteFilePath();
+        }
+    }
+}
+
+// **************************************************************************
+// load
+// **************************************************************************
+
+void PassStore::load()
+{
+    if (!storageReady || !passesDir.path().size()) {
+        qDebug() << "Storage directory not initialized";
+        return;
+    }
+
+    QVariantList failed;
+    QMap<QString, PassList> bundles;
+    PassList found;
+
+    // leftovers of imports interrupted before their commit
+
+    for (const auto& staging : passesDir.entryList({ ".import_*" }, QDir::Dirs | QDir::Hidden))
+        QDir(passesDir.filePath(staging)).removeRecursively();
+
+    packLegacyBundles();
+
+    // actually open all available .pkpass/.pkpasses files
+
+    readPasses(found, failed, bundles);
+    addBundlePasses(found, bundles);
+
+    // the passes found still hold their images, so only thumbnails of deleted passes go
+
+    ThumbnailCache::instance()->prune();
+
+    emit loaded(found, failed);
+}
+
+// **************************************************************************
+// importPass
+// **************************************************************************
+
+// batches are imported in two steps. first, all files are parsed in parallel and written into a
+// staging directory. the model then drops duplicates and hands the rest back to
+// commitImport(), which moves them into the passes directory in one go.
+
+namespace {
+class StageTask : public QRunnable {
+public:
+    explicit StageTask(std::function<void()> f) : f(std::move(f)) {}
+
+    void run() override
+    {
+        f();
+    }
+
+private:
+    std::function<void()> f;
+};
+} // namespace
+
+static QVariantMap failedImport(const QString& filePath, const QString& error)
+{
+    QVariantMap res;
+    res["filePath"] = filePath;
+    res["error"] = error;
+    return res;
+}
+
+void PassStore::importPasses(const QStringList& filePaths)
+{
+    QStringList sources;
+    QVariantList failed;
+
+    // directories contribute the passes they contain
+
+    for (QString fp : filePaths) {
+        if (fp.startsWith("file://"))
+            fp.remove("file://");
+
+        QFileInfo info(fp);
+
+        if (!info.isDir()) {
+            sources << fp;
+            continue;
+        }
+
+        for (const QFileInfo& entry : QDir(fp).entryInfoList(
+               { "*.pkpass", "*.pkpasses" }, QDir::Files | QDir::Readable | QDir::NoDotAndDotDot))
+            sources << entry.absoluteFilePath();
+    }
+
+    if (!storageReady) {
+        for (const auto& source : sources) {
+            failed << failedImport(
+              source, C::gettext("Storage directory inaccessible, cannot import pass"));
+        }
+
+        emit importCommitted(QString(), PassList(), failed);
+        return;
+    }
+
+    // the model tells pending batches apart by their staging path, so it must be unique even for
+    // imports started within the same millisecond
+
+    QDir stagingDir(passesDir.filePath(".import_"
+                                       + QString::number(QDateTime::currentMSecsSinceEpoch())
+                                       + "_" + QString::number(++importCount)));
+
+    if (!stagingDir.mkpath(".")) {
+        for (const auto& source : sources) {
+            failed << failedImport(
+              source, C::gettext("Failed to import pass into storage directory "));
+        }
+
+        emit importCommitted(QString(), PassList(), failed);
+        return;
+    }
+
+    // every task writes its own slot, each with its own parser
+
+    std::vector<PassResult> results(sources.size());
+    QAtomicInt done(0);
+    int total = sources.size();
+    QThreadPool pool;
+
+    emit importProgress(0, total);
+
+    for (int i = 0; i < total; i++) {
+        pool.start(new StageTask([this, i, total, &sources, &results, &done, &stagingDir]() {
+            Pkpass parser = pkpass;
+
+            // sources from different directories may share a file name (e.g. pass.pkpass), so
+            // every one is staged in a directory of its own
+
+            QDir passStagingDir(stagingDir.filePath(QString::number(i)));
+
+            if (passStagingDir.mkpath("."))
+                results[i] = stagePass(parser, sources[i], passStagingDir);
+            else
+                results[i] = QString(C::gettext("Failed to import pass into storage directory "));
+
+            emit importProgress(done.fetchAndAddOrdered(1) + 1, total);
+        }));
+    }
+
+    pool.waitForDone();
+
+    PassList passes;
+    QStringList staged;
+
+    for (int i = 0; i < total; i++) {
+        if (const QString* err = std::get_if<QString>(&results[i])) {
+            failed << failedImport(sources[i], *err);
+        } else {
+            passes.push_back(std::get<PassPtr>(results[i]));
+            staged << sources[i];
+        }
+    }
+
+    emit importStaged(stagingDir.path(), passes, staged, failed);
+}
+
+// **************************************************************************
+// stagePass
+// **************************************************************************
+
+// runs on the pool threads, so it only touches its arguments and the (unchanging) passes directory
+
+PassResult PassStore::stagePass(Pkpass& parser, const QString& filePath,
+                                const QDir& stagingDir) const
+{
+    if (!QFile::exists(filePath))
+        return QString(C::gettext("File path of the pass seems to be invalid"));
+
+    QFileInfo info(filePath);
+
+    if (QFile::exists(passesDir.filePath(info.fileName())))
+        return QString(C::gettext("Same pass has already been imported"));
+
+    QFile sourceFile(filePath);
+
+    if (!sourceFile.open(QIODevice::ReadOnly)) {
+        return QString(C::gettext("Failed to import pass into storage directory ")) + " ("
+               + sourceFile.errorString() + ")";
+    }
+
+    // the source is read once and validated in memory, only valid passes get written to staging.
+    // bundles are staged as the archive they came in.
+
+    auto data = sourceFile.readAll();
+    sourceFile.close();
+
+    info.setFile(stagingDir.filePath(info.fileName()));
+
+    PassResult passResult;
+
+    if (info.fileName().endsWith(".pkpasses")) {
+        auto bundleResult = parser.openBundle(data, info, QDateTime::currentDateTime());
+
+        if (QString* err = std::get_if<QString>(&bundleResult))
+            return QString(C::gettext("Failed to open pass bundle (%1)")).arg(*err);
+
+        passResult = makeBundlePass(info.baseName(), std::get<PassList>(bundleResult));
+    } else {
+        passResult = parser.openPass(data, info, QDateTime::currentDateTime());
+
+        if (QString* err = std::get_if<QString>(&passResult)) {
+            qDebug() << "Pass open failed: " << *err;
+
+            return QString(C::gettext("Failed to open pass")) + " (" + *err + ")";
+        }
+    }
+
+    QFile targetFile(info.absoluteFilePath());
+
+    if (!targetFile.open(QIODevice::WriteOnly | QIODevice::Truncate)
+        || targetFile.write(data) < data.size()) {
+        auto err = targetFile.errorString();
+        targetFile.remove();
+
+        return QString(C::gettext("Failed to import pass into storage directory ")) + " (" + err
+               + ")";
+    }
+
+    return passResult;
+}
+
+// **************************************************************************
+// commitImport
+// **************************************************************************
+
+// moves the accepted passes out of the staging directory. if one of the moves fails, the ones
+// already done are moved back and none of the passes is imported.
+
+void PassStore::commitImport(const QString& stagingPath, const PassList& passes,
+                             const QStringList& sources, const QVariantList& failed)
+{
+    QVariantList res = failed;
+    PassList committed;
+    QList<QPair<QString, QString>> moved; // staged path -> its target
+    QSet<size_t> rejected;
+    bool ok = true;
+
+    auto targetPath = [this](const QString& filePath) {
+        return passesDir.filePath(QFileInfo(filePath).fileName());
+    };
+
+    for (size_t i = 0; i < passes.size() && ok; i++) {
+        const auto& pass = passes[i];
+        PassList files = pass->bundlePasses.empty() ? PassList {pass} : pass->bundlePasses;
+
+        // the passes of a bundle share its archive
+
+        QStringList stagedPaths;
+
+        for (const auto& file : files) {
+            if (!stagedPaths.contains(file->filePath))
+                stagedPaths << file->filePath;
+        }
+
+        // a pass which showed up in the meantime is rejected on its own
+
+        bool exists = std::any_of(stagedPaths.begin(), stagedPaths.end(),
+                                  [&targetPath](const QString& staged) {
+                                      return QFile::exists(targetPath(staged));
+                                  });
+
+        if (exists) {
+            rejected.insert(i);
+            res << failedImport(sources.value(i),
+                                C::gettext("Same pass has already been imported"));
+            continue;
+        }
+
+        for (const auto& staged : stagedPaths) {
+            QString target = targetPath(staged);
+
+            if (!QFile::rename(staged, target)) {
+                ok = false;
+                break;
+            }
+
+            moved << qMakePair(staged, target);
+        }
+
+        if (!ok)
+            break;
+
+        for (const auto& file : files)
+            file->filePath = targetPath(file->filePath);
+
+        committed.push_back(pass);
+    }
+
+    if (!ok) {
+        for (const auto& move : moved)
+            QFile::rename(move.second, move.first);
+
+        // passes rejected above are already listed
+
+        for (size_t i = 0; i < passes.size(); i++) {
+            if (rejected.contains(i))
+                continue;
+
+            res << failedImport(sources.value(i),
+                                C::gettext("Failed to import pass into storage directory "));
+        }
+
+        committed.clear();
+    }
+
+    QDir(stagingPath).removeRecursively();
+
+    emit importCommitted(stagingPath, committed, res);
+}
+
+// **************************************************************************
+// removeFiles
+// **************************************************************************
+
+// stops at the first file that can't be removed, id is handed back to tell requests apart
+
+void PassStore::removeFiles(const QString& id, const QStringList& filePaths)
+{
+    for (const auto& filePath : filePaths) {
+        if (!QFile::exists(filePath)) {
+            emit filesRemoved(id, filePaths, C::gettext("Failed to delete pass (pass unknown)"));
+            return;
+        }
+
+        QFile passFile(filePath);
+        bool res = passFile.remove();
+
+        if (!res) {
+            emit filesRemoved(
+              id, filePaths,
+              QString(C::gettext("Failed to delete pass from storage directory (%1)"))
+                .arg(passFile.errorString()));
+            return;
+        }
+    }
+
+    emit filesRemoved(id, filePaths, "");
+}
+
+// **************************************************************************
+// storeUpdate
+// **************************************************************************
+
+// try to open the payload (= new pass) from memory. only if successful, it replaces the old file.
+
+void PassStore::storeUpdate(const QString& id, const QString& filePath, const QByteArray& data)
+{
+    auto fail = [this, &id](const QString& err) { emit updateStored(id, PassResult {err}); };
+
+    auto passResult = pkpass.openPass(data, QFileInfo(filePath), QDateTime::currentDateTime());
+
+    if (std::holds_alternative<PassPtr>(passResult)) {
+        QSaveFile passFile(filePath);
+
+        if (!passFile.open(QIODevice::WriteOnly))
+            return fail(
+              QString(
+                C::gettext("Failed to save pass update to storage / could not open file (%1)"))
+                .arg(passFile.errorString()));
+
+        if (passFile.write(data) < data.size())
+            return fail(
+              QString(
+                C::gettext("Failed to save pass update to storage / could not write file (%1)"))
+                .arg(passFile.errorString()));
+
+        if (!passFile.commit()) {
+            return fail(
+              QString(C::gettext(
+                        "Failed to save pass update to storage / could replace existing pass (%1)"))
+                .arg(passFile.errorString()));
+        }
+    }
+
+    emit updateStored(id, passResult);
+}
+
+} // namespace passes
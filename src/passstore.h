@@ -0,0 +1,87 @@
+// **************************************************************************
+// class PassStore
+// 19.10.2026
+// Owner of the passes directory, runs all pass file I/O on a worker thread
+// **************************************************************************
+// MIT License
+// Copyright © 2021 Patrick Fial
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions: The above copyright notice and this
+// permission notice shall be included in all copies or substantial portions of the Software. THE
+// SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+// LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// **************************************************************************
+// includes
+// **************************************************************************
+
+#ifndef PASSSTORE_H
+#define PASSSTORE_H
+
+#include <QDir>
+#include <QFont>
+#include <QObject>
+#include <QStringList>
+#include <QVariantList>
+
+#include "pkpass.h"
+
+// **************************************************************************
+// class PassStore
+// **************************************************************************
+
+// lives on its own thread and is only talked to through queued calls of its slots. results are
+// published as signals, passes handed out are not touched by the store anymore.
+
+namespace passes {
+class PassStore : public QObject {
+    Q_OBJECT
+
+public:
+    explicit PassStore(QObject* parent = nullptr);
+
+public slots:
+    void init(const QString& dataPath);
+    void setDefaultFont(const QFont& font);
+
+    void load();
+    void importPasses(const QStringList& filePaths);
+    void commitImport(const QString& stagingPath, const passes::PassList& passes,
+                      const QStringList& sources, const QVariantList& failed);
+    void removeFiles(const QString& id, const QStringList& filePaths);
+    void storeUpdate(const QString& id, const QString& filePath, const QByteArray& data);
+
+signals:
+    void initialized(QString error);
+    void loaded(passes::PassList passes, QVariantList failed);
+    void importProgress(int done, int total);
+    void importStaged(QString stagingPath, passes::PassList passes, QStringList sources,
+                      QVariantList failed);
+    void importCommitted(QString stagingPath, passes::PassList passes, QVariantList failed);
+    void filesRemoved(QString id, QStringList filePaths, QString error);
+    void updateStored(QString id, passes::PassResult result);
+
+private:
+    void packLegacyBundles();
+    void readPasses(PassList& found, QVariantList& failed, QMap<QString, PassList>& bundles);
+    void addBundlePasses(PassList& found, QMap<QString, PassList>& bundles);
+    PassResult stagePass(Pkpass& parser, const QString& filePath, const QDir& stagingDir) const;
+
+    bool storageReady;
+    int importCount;
+    QDir passesDir;
+    Pkpass pkpass;
+};
+
+} // namespace passes
+
+Q_DECLARE_METATYPE(passes::PassList)
+Q_DECLARE_METATYPE(passes::PassResult)
+
+#endif // PASSSTORE_H
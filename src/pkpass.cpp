@@ -33,51 +33,14 @@
 #include <QJsonObject>
 
 #include "barcode.h"
+#include "colors.h"
 #include "quazip/quazipfile.h"
 
 namespace C {
 #include <libintl.h>
 }
 
-#include <cmath>
-namespace colors {
-
-// luminosity calculation as per
-// https://stackoverflow.com/questions/596216/formula-to-determine-perceived-brightness-of-rgb-color
-
-double sRGBtoLin(double colorChannel)
-{
-    if (colorChannel <= 0.04045)
-        return colorChannel / 12.92;
-
-    return pow(((colorChannel + 0.055) / 1.055), 2.4);
-}
-
-double getLuminance(const QColor& color)
-{
-    double vR = static_cast<double>(color.red()) / 255.0;
-    double vG = static_cast<double>(color.green()) / 255.0;
-    double vB = static_cast<double>(color.blue()) / 255.0;
-
-    return (0.2126 * sRGBtoLin(vR) + 0.7152 * sRGBtoLin(vG) + 0.0722 * sRGBtoLin(vB));
-}
-} // namespace colors
-
 namespace passes {
-QByteArray fileMd5(const QString& fileName)
-{
-    QFile f(fileName);
-
-    if (f.open(QFile::ReadOnly)) {
-        QCryptographicHash hash(QCryptographicHash::Md5);
-
-        if (hash.addData(&f))
-            return hash.result().toHex();
-    }
-
-    return QByteArray();
-}
-
 QByteArray dataMd5(const QByteArray& data)
 {
     QCryptographicHash hash(QCryptographicHash::Md5);
@@ -86,6 +49,18 @@ QByteArray dataMd5(const QByteArray& data)
     return hash.result().toHex();
 }
 
+// parse straight from the mapped file, nothing parsed keeps pointing into the raw data. the
+// mapping lives as long as the (open) file.
+
+static QByteArray mapFile(QFile& file)
+{
+    auto size = file.size();
+    auto mapped = size > 0 ? file.map(0, size) : nullptr;
+
+    return mapped ? QByteArray::fromRawData(reinterpret_cast<const char*>(mapped), size)
+                  : file.readAll();
+}
+
 // **************************************************************************
 // class PkpassParser
 // **************************************************************************
@@ -98,97 +73,67 @@ Pkpass::Pkpass()
 }
 
 // **************************************************************************
-// extractBundle
+// openBundle
 // **************************************************************************
 
-BundleResult Pkpass::extractBundle(const QFileInfo& info)
+BundleResult Pkpass::openBundle(const QFileInfo& info)
+{
+    QFile bundleFile(info.absoluteFilePath());
+
+    if (!bundleFile.open(QIODevice::ReadOnly))
+        return QString(C::gettext("Can't open passes bundle (%1)")).arg(bundleFile.errorString());
+
+    return openBundle(mapFile(bundleFile), info, info.lastModified());
+}
+
+// the archive stays as it is, its passes are opened in place and all refer to the archive file
+
+BundleResult Pkpass::openBundle(const QByteArray& data, const QFileInfo& info,
+                                const QDateTime& modified)
 {
-    QuaZip archive(info.absoluteFilePath());
+    QBuffer buffer;
+    buffer.setData(data);
+
+    QuaZip archive(&buffer);
     PassList bundlePasses;
 
     if (!archive.open(QuaZip::mdUnzip))
         return QString(C::gettext("Can't open passes bundle (%1)")).arg(archive.getZipError());
 
-    auto passBundlePrefix = "BUNDLE_" + info.baseName() + "_BUNDLE_";
     auto archiveContents = archive.getFileNameList();
-    std::optional<QString> res = std::nullopt;
 
     for (auto& fileName : archiveContents) {
-        QFileInfo extractedFileName;
-        extractedFileName.setFile(info.dir(), passBundlePrefix + fileName);
-
-        if (QFile::exists(extractedFileName.absoluteFilePath())) {
-            res = QString(C::gettext("Contained bundle pass already exists, can't extract bundle"));
-            break;
-        }
-
         archive.setCurrentFile(fileName);
 
-        QString err;
         QuaZipFile archiveFile(&archive);
-        QFile targetFile(extractedFileName.absoluteFilePath());
 
         if (!archiveFile.open(QIODevice::ReadOnly)) {
-            res = QString(
-                    C::gettext("Failed to open bundle/bundle contents, can't extract bundle (%1)"))
-                    .arg(archive.getZipError());
-            break;
-        }
-
-        if (!targetFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
-            archiveFile.close();
-            res = QString(C::gettext(
-                            "Failed to open extracted pass for writing, can't extract bundle (%1)"))
-                    .arg(targetFile.errorString());
-            break;
+            archive.close();
+            return QString(C::gettext("Failed to open bundle/bundle contents (%1)"))
+              .arg(archive.getZipError());
         }
 
         auto contents = archiveFile.readAll();
-        auto written = targetFile.write(contents);
-
-        targetFile.close();
         archiveFile.close();
 
-        if (written < contents.size()) {
-            res = QString(C::gettext("Failed extract pass from bundle (%1)"))
-                    .arg(targetFile.errorString());
-            break;
-        }
-
-        auto passResult = openPass(extractedFileName.absoluteFilePath());
+        auto passResult = openPass(contents, info, modified);
 
         if (QString* err = std::get_if<QString>(&passResult)) {
-            qDebug() << "Unable to open extracted pass: " << *err;
+            qDebug() << "Unable to open pass of bundle: " << *err;
 
-            res = QString(C::gettext("Unable to open extracted pass from bundle (%1)")).arg(*err);
-            break;
+            archive.close();
+            return QString(C::gettext("Unable to open pass from bundle (%1)")).arg(*err);
         }
 
-        bundlePasses.push_back(std::get<PassPtr>(passResult));
+        auto pass = std::get<PassPtr>(passResult);
+        pass->bundleName = info.baseName();
+        bundlePasses.push_back(pass);
     }
 
     archive.close();
 
-    if (!res) {
-        if (!QFile::remove(info.absoluteFilePath())) {
-            res = QString(C::gettext("Failed to delete bundle after extraction"));
-        }
-    } else {
-        for (const QFileInfo& info : info.dir().entryInfoList(
-               QDir::Files | QDir::NoSymLinks | QDir::NoDotAndDotDot | QDir::Readable)) {
-            if (info.fileName().startsWith(".") || !info.fileName().endsWith(".pkpass")
-                || !info.fileName().startsWith(passBundlePrefix))
-                continue;
-
-            qDebug() << "Delete extracted pass from incomplete/corrupt bundle "
-                     << info.absoluteFilePath();
-
-            if (!QFile::remove(info.absoluteFilePath())) {
-                res = QString(C::gettext(
-                  "Failed to delete already extracted pass(es) of incomplete/corrupt bundle"));
-            }
-        }
-    }
+    if (bundlePasses.empty())
+        return QString(C::gettext("Bundle does not contain any pass"));
 
     return bundlePasses;
 }
@@ -198,11 +143,27 @@ BundleResult Pkpass::extractBundle(const QFileInfo& info)
 // **************************************************************************
 
 PassResult Pkpass::openPass(const QFileInfo& info)
+{
+    QFile file(info.absoluteFilePath());
+
+    if (!file.open(QIODevice::ReadOnly))
+        return QString(C::gettext("Failed to open pass file (%1)")).arg(file.errorString());
+
+    return openPass(mapFile(file), info, info.lastModified());
+}
+
+// info is where the pass file lives (or will be written to), the data isn't touched on disk here
+
+PassResult Pkpass::openPass(const QByteArray& data, const QFileInfo& info,
+                            const QDateTime& modified)
 {
     auto pass = std::make_shared<Pass>();
     currentTranslation.clear();
 
-    QuaZip archive(info.absoluteFilePath());
+    QBuffer buffer;
+    buffer.setData(data);
+
+    QuaZip archive(&buffer);
 
     bool res = archive.open(QuaZip::mdUnzip);
 
@@ -217,6 +178,7 @@ PassResult Pkpass::openPass(const QFileInfo& info)
     QString err = readLocalization(pass, archive, archiveContents);
 
     pass->haveStripImage = false;
+    pass->haveBackgroundImage = false;
 
     if (err.isEmpty())
         err = readPass(pass, archive);
@@ -239,8 +201,8 @@ PassResult Pkpass::openPass(const QFileInfo& info)
     }
 
     pass->details.maxFieldLabelWidth = maxWidth;
-    pass->id = fileMd5(info.absoluteFilePath());
-    pass->modified = info.lastModified();
+    pass->id = dataMd5(data);
+    pass->modified = modified;
     pass->filePath = info.absoluteFilePath();
     pass->bundleExpired = false;
     pass->bundleIndex = -1;
@@ -254,9 +216,82 @@ PassResult Pkpass::openPass(const QFileInfo& info)
     if (!pass->sortingDate.isValid())
         pass->sortingDate = pass->modified;
 
+    pass->updateSortKeys();
+
     return pass;
 }
 
+// **************************************************************************
+// Pass::updateSortKeys
+// **************************************************************************
+
+// 40 bits of seconds (offset, so dates before 1970 keep their order) and 24 bits of tie-breaker
+
+static const qint64 timeBits = 40;
+static const quint64 timeMask = (quint64(1) << timeBits) - 1;
+
+static quint64 timeKey(const QDateTime& date, bool descending, quint32 tieBreaker)
+{
+    quint64 secs = timeMask;
+
+    if (date.isValid()) {
+        qint64 t = date.toSecsSinceEpoch() + (qint64(1) << (timeBits - 1));
+        secs = quint64(qBound(qint64(0), t, qint64(timeMask)));
+
+        if (descending)
+            secs = timeMask - secs;
+    }
+
+    return (secs << (64 - timeBits)) | (tieBreaker & 0xffffff);
+}
+
+static quint32 idHash(const QString& id)
+{
+    // FNV-1a, qHash is seeded per process and would not give the same order on every start
+
+    quint32 hash = 2166136261u;
+
+    for (const QChar& c : id)
+        hash = (hash ^ c.unicode()) * 16777619u;
+
+    return hash;
+}
+
+static quint64 styleRank(const QString& style)
+{
+    static const QStringList styles = { "boardingPass", "eventTicket", "coupon", "storeCard",
+                                        "generic" };
+    int idx = styles.indexOf(style);
+
+    return idx < 0 ? styles.size() : idx;
+}
+
+void Pass::updateSortKeys()
+{
+    // bundles are sorted like their first pass, but expire with their last one
+
+    const Pass& first = bundlePasses.empty() ? *this : *bundlePasses.front();
+    QDateTime expires = bundlePasses.empty() ? standard.expiresAt : QDateTime();
+    bool neverExpires = false;
+
+    for (const auto& bundlePass : bundlePasses) {
+        if (!bundlePass->standard.expiresAt.isValid())
+            neverExpires = true;
+        else if (!expires.isValid() || bundlePass->standard.expiresAt > expires)
+            expires = bundlePass->standard.expiresAt;
+    }
+
+    if (neverExpires)
+        expires = QDateTime();
+
+    quint32 tieBreaker = idHash(id);
+
+    sortKey = timeKey(sortingDate, true, tieBreaker);
+    expiryKey = timeKey(expires, false, tieBreaker);
+    styleKey = (styleRank(first.details.style) << 60) | (sortKey >> 4);
+    organizationKey = first.standard.organization.toCaseFolded();
+}
+
 // **************************************************************************
 // readPassJson
 // **************************************************************************
@@ -375,10 +410,15 @@ QString Pkpass::readPassStandard(PassPtr pass, QJsonObject& object)
     translate(pass->standard.description);
     translate(pass->standard.organization);
 
+    pass->standard.passTypeIdentifier = object["passTypeIdentifier"].toString();
+    pass->standard.serialNumber = object["serialNumber"].toString();
+
     if (object.contains("expirationDate")) {
         pass->standard.expirationDate = object["expirationDate"].toString();
         QDateTime dt = QDateTime::fromString(pass->standard.expirationDate, Qt::ISODate);
 
+        pass->standard.expiresAt = dt;
+
         if (QDateTime::currentDateTime().secsTo(dt) <= 0)
             pass->standard.expired = true;
     }
@@ -387,15 +427,28 @@ QString Pkpass::readPassStandard(PassPtr pass, QJsonObject& object)
         pass->standard.relevantDate = object["relevantDate"].toString();
         pass->sortingDate = QDateTime::fromString(pass->standard.relevantDate, Qt::ISODate);
 
-        if (!object.contains("expirationDate")
-            && QDateTime::currentDateTime().secsTo(pass->sortingDate) <= 0) {
-            pass->standard.expired = true;
+        if (!object.contains("expirationDate")) {
+            pass->standard.expiresAt = pass->sortingDate;
+
+            if (QDateTime::currentDateTime().secsTo(pass->sortingDate) <= 0)
+                pass->standard.expired = true;
         }
     }
 
     if (object.contains("voided"))
         pass->standard.voided = object["voided"].toBool();
 
+    pass->standard.maxDistance = 0;
+
+    if (object.contains("maxDistance"))
+        pass->standard.maxDistance = qMax(object["maxDistance"].toInt(), 0);
+
+    if (object.contains("locations"))
+        readPassLocations(pass, object["locations"].toArray());
+
+    if (object.contains("beacons"))
+        readPassBeacons(pass, object["beacons"].toArray());
+
     if (object.contains("backgroundColor"))
         pass->standard.backgroundColor = parseColor(object["backgroundColor"].toString());
 
@@ -462,7 +515,7 @@ QString Pkpass::readPassBarcode(PassPtr pass, QJsonObject object)
     bc.encoding = encoding;
     bc.altText = altText;
 
-    auto errString = BarcodeGenerator::generate(message, format, &bc.image);
+    auto errString = BarcodeGenerator::validate(format);
 
     if (!errString.isEmpty())
         return errString;
@@ -475,6 +528,58 @@ QString Pkpass::readPassBarcode(PassPtr pass, QJsonObject object)
     return errString;
 }
 
+// **************************************************************************
+// readPassLocations
+// **************************************************************************
+
+// locations and beacons only make a pass show up as relevant, so broken entries are skipped
+// instead of rejecting the whole pass
+
+void Pkpass::readPassLocations(PassPtr pass, QJsonArray array)
+{
+    for (int i = 0; i < array.size(); i++) {
+        auto object = array[i].toObject();
+
+        if (!object["latitude"].isDouble() || !object["longitude"].isDouble())
+            continue;
+
+        Location location;
+        location.latitude = object["latitude"].toDouble();
+        location.longitude = object["longitude"].toDouble();
+        location.altitude = object["altitude"].toDouble();
+        location.relevantText = object["relevantText"].toString();
+
+        if (qAbs(location.latitude) > 90.0 || qAbs(location.longitude) > 180.0)
+            continue;
+
+        location.relevantText = translate(location.relevantText);
+        pass->standard.locations.push_back(std::move(location));
+    }
+}
+
+// **************************************************************************
+// readPassBeacons
+// **************************************************************************
+
+void Pkpass::readPassBeacons(PassPtr pass, QJsonArray array)
+{
+    for (int i = 0; i < array.size(); i++) {
+        auto object = array[i].toObject();
+
+        if (!object.contains("proximityUUID"))
+            continue;
+
+        Beacon beacon;
+        beacon.proximityUUID = object["proximityUUID"].toString().toUpper();
+        beacon.major = object.contains("major") ? object["major"].toInt() : -1;
+        beacon.minor = object.contains("minor") ? object["minor"].toInt() : -1;
+        beacon.relevantText = object["relevantText"].toString();
+
+        beacon.relevantText = translate(beacon.relevantText);
+        pass->standard.beacons.push_back(std::move(beacon));
+    }
+}
+
 // **************************************************************************
 // readPassStyle
 // **************************************************************************
@@ -604,17 +709,24 @@ QString Pkpass::readImages(PassPtr pass, QuaZip& archive, const QStringList& arc
     if (err.isEmpty())
         err = readImage(&pass->imgThumbnail, archive, archiveContents, "thumbnail");
 
+    pass->haveBackgroundImage = !pass->imgBackground.isNull();
+
     if (!pass->imgStrip.isNull()) {
         pass->haveStripImage = true;
 
         // check if we need different color for the strip foreground text in case the
-        // strip color does not match well with the passes foreground text color
+        // strip color does not match well with the passes foreground text color. the primary
+        // fields are drawn onto the left part of the strip, so only that area is sampled.
+
+        double lumStrip = colors::getImageLuminance(pass->imgStrip.variants.first(),
+                                                    QRectF(0.0, 0.0, 0.6, 1.0));
+
+        if (lumStrip < 0.0)
+            return C::gettext("Pass contains invalid/incomplete image data");
 
-        QColor colorOfStrip = QColor::fromRgb(pass->imgStrip.pixel(10, 10));
         QColor passForegroundColor(pass->standard.foregroundColor);
         QColor passLabelColor(pass->standard.labelColor);
 
-        double lumStrip = colors::getLuminance(colorOfStrip);
         double lumForground = colors::getLuminance(passForegroundColor);
         double lumLabel = colors::getLuminance(passLabelColor);
 
@@ -636,30 +748,103 @@ QString Pkpass::readImages(PassPtr pass, QuaZip& archive, const QStringList& arc
 // readImage
 // **************************************************************************
 
-QString Pkpass::readImage(QImage* dest, QuaZip& archive, const QStringList& archiveContents,
+QString Pkpass::readImage(PassImage* dest, QuaZip& archive, const QStringList& archiveContents,
                           QString imageName)
 {
-    static QStringList extensions {"@3x.png", "@2x.png", ".png"};
+    static QList<QPair<int, QString>> variants {{1, ".png"}, {2, "@2x.png"}, {3, "@3x.png"}};
 
-    bool res = true;
+    // only read the compressed variants here. which one gets decoded depends on the screen and
+    // the displayed size, and is decided once the image is actually shown.
 
-    foreach (const QString ext, extensions) {
-        if (!archiveContents.contains(imageName + ext))
+    for (const auto& variant : variants) {
+        if (!archiveContents.contains(imageName + variant.second))
             continue;
 
-        archive.setCurrentFile(imageName + ext);
+        archive.setCurrentFile(imageName + variant.second);
 
         QuaZipFile file(&archive);
 
         file.open(QIODevice::ReadOnly);
 
-        res = dest->loadFromData(file.readAll());
+        // byte-identical files of other passes (e.g. all legs of a bundle) resolve to the same
+        // stored image, and will only be decoded once
+
+        auto image = ImageStore::instance()->intern(file.readAll());
 
         file.close();
-        break;
+
+        if (!image)
+            return C::gettext("Pass contains invalid/incomplete image data");
+
+        dest->variants.insert(variant.first, image);
+    }
+
+    return "";
+}
+
+// **************************************************************************
+// class PassImage
+// **************************************************************************
+
+int PassImage::pickScale(qreal devicePixelRatio, const QSize& requestedSize) const
+{
+    bool sized = requestedSize.width() > 0 || requestedSize.height() > 0;
+
+    // smallest variant which covers the displayed size. without any size given, the smallest
+    // one at least as dense as the screen.
+
+    for (auto it = variants.begin(); it != variants.end(); ++it) {
+        const QSize& size = it.value()->size;
+
+        if (sized && (requestedSize.width() <= 0 || size.width() >= requestedSize.width())
+            && (requestedSize.height() <= 0 || size.height() >= requestedSize.height()))
+            return it.key();
+
+        if (!sized && it.key() >= devicePixelRatio)
+            return it.key();
     }
 
-    return res ? "" : C::gettext("Pass contains invalid/incomplete image data");
+    return variants.lastKey();
+}
+
+ImageHandle PassImage::pick(qreal devicePixelRatio, const QSize& requestedSize,
+                            QSize* scaledSize) const
+{
+    if (variants.isEmpty())
+        return nullptr;
+
+    int scale = pickScale(devicePixelRatio, requestedSize);
+    const ImageHandle& image = variants[scale];
+    QSize targetSize;
+
+    // only an oversized variant available, let the decoder scale down instead of keeping the
+    // full size image around
+
+    if (requestedSize.width() > 0 && requestedSize.height() > 0)
+        targetSize = image->size.scaled(requestedSize, Qt::KeepAspectRatio);
+    else if (requestedSize.width() > 0)
+        targetSize = QSize(requestedSize.width(),
+                           image->size.height() * requestedSize.width() / image->size.width());
+    else if (requestedSize.height() > 0)
+        targetSize = QSize(image->size.width() * requestedSize.height() / image->size.height(),
+                           requestedSize.height());
+    else if (devicePixelRatio >= 1.0 && scale > devicePixelRatio)
+        targetSize = image->size * (devicePixelRatio / scale);
+
+    if (!targetSize.isValid() || targetSize.isEmpty() || targetSize.width() >= image->size.width())
+        targetSize = QSize();
+
+    *scaledSize = targetSize;
+
+    return image;
+}
+
+QImage PassImage::decode(qreal devicePixelRatio, const QSize& requestedSize) const
+{
+    QSize scaledSize;
+    ImageHandle image = pick(devicePixelRatio, requestedSize, &scaledSize);
+
+    return ImageStore::instance()->decode(image, scaledSize);
 }
 
 // **************************************************************************
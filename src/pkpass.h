@@ -24,6 +24,7 @@
 #ifndef PKPASS_H
 #define PKPASS_H
 
+#include <QCryptographicHash>
 #include <QDateTime>
 #include <QDebug>
 #include <QFileInfo>
@@ -34,6 +35,7 @@
 #include <QObject>
 #include <QRegExp>
 
+#include "imagestore.h"
 #include "quazip/quazip.h"
 #include <memory>
 
@@ -48,52 +50,141 @@ static QString fileThumbnailPng = "thumbnail.png";
 
 using Translation = QMap<QString, QString>;
 
+// **************************************************************************
+// struct PassImage
+// **************************************************************************
+
+// the @1x/@2x/@3x files of one pass image, kept compressed until they are displayed
+
+struct PassImage {
+    QMap<int, ImageHandle> variants; // scale factor -> image
+
+    bool isNull() const
+    {
+        return variants.isEmpty();
+    }
+
+    int pickScale(qreal devicePixelRatio, const QSize& requestedSize) const;
+    ImageHandle pick(qreal devicePixelRatio, const QSize& requestedSize, QSize* scaledSize) const;
+    QImage decode(qreal devicePixelRatio, const QSize& requestedSize) const;
+};
+
 // **************************************************************************
 // struct PassItem
 // **************************************************************************
 
+// the structs below are gadgets, so QML reads their members as typed properties of shared
+// (implicitly copied) data instead of looking them up in freshly built QVariantMaps
+
+template <typename T>
+QVariantList toVariantList(const QList<T>& list)
+{
+    QVariantList res;
+    res.reserve(list.size());
+
+    for (const auto& item : list)
+        res << QVariant::fromValue(item);
+
+    return res;
+}
+
 struct Barcode {
+    Q_GADGET
+    Q_PROPERTY(QString format MEMBER format)
+    Q_PROPERTY(QString message MEMBER message)
+    Q_PROPERTY(QString encoding MEMBER encoding)
+    Q_PROPERTY(QString altText MEMBER altText)
+
+public:
     QString format;
     QString message;
     QString encoding;
     QString altText;
-    QImage image;
 
-    explicit operator QVariant() const
+    // rendered on demand, the image only lives in the image cache
+
+    QByteArray cacheKey() const
     {
-        QVariantMap m;
-        m.insert("format", format);
-        m.insert("message", message);
-        m.insert("encoding", encoding);
-        m.insert("altText", altText);
-        return m;
+        auto content = (format + "\n" + encoding + "\n" + message).toUtf8();
+        return "barcode/" + QCryptographicHash::hash(content, QCryptographicHash::Md5);
     }
 };
 
 struct WebService {
+    Q_GADGET
+    Q_PROPERTY(QString url MEMBER url)
+    Q_PROPERTY(bool webserviceBroken MEMBER webserviceBroken)
+
+public:
     QString accessToken;
     QString url;
     bool webserviceBroken;
+};
 
-    explicit operator QVariant() const
-    {
-        QVariantMap m;
-        m.insert("url", url);
-        m.insert("webserviceBroken", webserviceBroken);
+struct Location {
+    Q_GADGET
+    Q_PROPERTY(double latitude MEMBER latitude)
+    Q_PROPERTY(double longitude MEMBER longitude)
+    Q_PROPERTY(double altitude MEMBER altitude)
+    Q_PROPERTY(QString relevantText MEMBER relevantText)
 
-        return m;
-    }
+public:
+    double latitude;
+    double longitude;
+    double altitude;
+    QString relevantText;
+};
+
+struct Beacon {
+    Q_GADGET
+    Q_PROPERTY(QString proximityUUID MEMBER proximityUUID)
+    Q_PROPERTY(int major MEMBER major)
+    Q_PROPERTY(int minor MEMBER minor)
+    Q_PROPERTY(QString relevantText MEMBER relevantText)
+
+public:
+    QString proximityUUID;
+    int major; // -1 if not given
+    int minor; // -1 if not given
+    QString relevantText;
 };
 
 struct Standard {
+    Q_GADGET
+    Q_PROPERTY(QString description MEMBER description)
+    Q_PROPERTY(QString organization MEMBER organization)
+    Q_PROPERTY(QString passTypeIdentifier MEMBER passTypeIdentifier)
+    Q_PROPERTY(QString serialNumber MEMBER serialNumber)
+    Q_PROPERTY(QString expirationDate MEMBER expirationDate)
+    Q_PROPERTY(QString relevantDate MEMBER relevantDate)
+    Q_PROPERTY(bool voided MEMBER voided)
+    Q_PROPERTY(bool expired MEMBER expired)
+    Q_PROPERTY(QVariantList barcodes READ getBarcodes)
+    Q_PROPERTY(QVariantList locations READ getLocations)
+    Q_PROPERTY(QVariantList beacons READ getBeacons)
+    Q_PROPERTY(int maxDistance MEMBER maxDistance)
+    Q_PROPERTY(QString backgroundColor MEMBER backgroundColor)
+    Q_PROPERTY(QString foregroundColor MEMBER foregroundColor)
+    Q_PROPERTY(QString labelColor MEMBER labelColor)
+    Q_PROPERTY(QString logoText MEMBER logoText)
+    Q_PROPERTY(QString barcodeFormat MEMBER barcodeFormat)
+    Q_PROPERTY(QString stripExtraForegroundColor MEMBER stripExtraForegroundColor)
+    Q_PROPERTY(QString stripExtraLabelColor MEMBER stripExtraLabelColor)
+
+public:
     QString description;
     QString organization;
+    QString passTypeIdentifier;
+    QString serialNumber;
     QString expirationDate;
     QString relevantDate;
     bool voided;
     bool expired;
 
     QList<Barcode> barcodes;
+    QList<Location> locations;
+    QList<Beacon> beacons;
+    int maxDistance; // meters, 0 if not given
     QString backgroundColor;
     QString foregroundColor;
     QString labelColor;
@@ -102,51 +193,46 @@ struct Standard {
     QString stripExtraForegroundColor;
     QString stripExtraLabelColor;
 
-    explicit operator QVariant() const
+    QDateTime expiresAt; // expiration date, or the relevant date if there is none
+
+    QVariantList getBarcodes() const
+    {
+        return toVariantList(barcodes);
+    }
+    QVariantList getLocations() const
     {
-        QVariantMap m;
-        m.insert("description", description);
-        m.insert("organization", organization);
-        m.insert("expirationDate", expirationDate);
-        m.insert("relevantDate", relevantDate);
-        m.insert("voided", voided);
-        m.insert("expired", expired);
-        m.insert("backgroundColor", backgroundColor);
-        m.insert("foregroundColor", foregroundColor);
-        m.insert("labelColor", labelColor);
-        m.insert("logoText", logoText);
-        m.insert("organization", organization);
-        m.insert("barcodeFormat", barcodeFormat);
-        m.insert("stripExtraForegroundColor", stripExtraForegroundColor);
-        m.insert("stripExtraLabelColor", stripExtraLabelColor);
-
-        QVariantList codes;
-
-        for (const auto& barcode : barcodes)
-            codes << static_cast<QVariant>(barcode);
-
-        m.insert("barcodes", codes);
-
-        return m;
+        return toVariantList(locations);
+    }
+    QVariantList getBeacons() const
+    {
+        return toVariantList(beacons);
     }
 };
 
 struct PassStyleField {
+    Q_GADGET
+    Q_PROPERTY(QString key MEMBER key)
+    Q_PROPERTY(QString value MEMBER value)
+    Q_PROPERTY(QString label MEMBER label)
+
+public:
     QString key;
     QString value;
     QString label;
-
-    explicit operator QVariant() const
-    {
-        QVariantMap m;
-        m.insert("key", key);
-        m.insert("value", value);
-        m.insert("label", label);
-        return m;
-    }
 };
 
 struct PassStyle {
+    Q_GADGET
+    Q_PROPERTY(QString style MEMBER style)
+    Q_PROPERTY(QVariantList headerFields READ getHeaderFields)
+    Q_PROPERTY(QVariantList primaryFields READ getPrimaryFields)
+    Q_PROPERTY(QVariantList secondaryFields READ getSecondaryFields)
+    Q_PROPERTY(QVariantList auxiliaryFields READ getAuxiliaryFields)
+    Q_PROPERTY(QVariantList backFields READ getBackFields)
+    Q_PROPERTY(QString transitType MEMBER transitType)
+    Q_PROPERTY(qreal maxFieldLabelWidth MEMBER maxFieldLabelWidth)
+
+public:
     QString style;
     QList<PassStyleField> headerFields;
     QList<PassStyleField> primaryFields;
@@ -156,49 +242,25 @@ struct PassStyle {
     QString transitType;
     qreal maxFieldLabelWidth;
 
-    explicit operator QVariant() const
+    QVariantList getHeaderFields() const
     {
-        QVariantMap m;
-        m.insert("style", style);
-        m.insert("transitType", transitType);
-        m.insert("maxFieldLabelWidth", maxFieldLabelWidth);
-
-        QVariantList fields;
-
-        for (const auto& f : headerFields)
-            fields << static_cast<QVariant>(f);
-
-        m.insert("headerFields", fields);
-
-        fields.clear();
-
-        for (const auto& f : primaryFields)
-            fields << static_cast<QVariant>(f);
-
-        m.insert("primaryFields", fields);
-
-        fields.clear();
-
-        for (const auto& f : secondaryFields)
-            fields << static_cast<QVariant>(f);
-
-        m.insert("secondaryFields", fields);
-
-        fields.clear();
-
-        for (const auto& f : auxiliaryFields)
-            fields << static_cast<QVariant>(f);
-
-        m.insert("auxiliaryFields", fields);
-
-        fields.clear();
-
-        for (const auto& f : backFields)
-            fields << static_cast<QVariant>(f);
-
-        m.insert("backFields", fields);
-
-        return m;
+        return toVariantList(headerFields);
+    }
+    QVariantList getPrimaryFields() const
+    {
+        return toVariantList(primaryFields);
+    }
+    QVariantList getSecondaryFields() const
+    {
+        return toVariantList(secondaryFields);
+    }
+    QVariantList getAuxiliaryFields() const
+    {
+        return toVariantList(auxiliaryFields);
+    }
+    QVariantList getBackFields() const
+    {
+        return toVariantList(backFields);
     }
 };
 
@@ -218,50 +280,34 @@ struct Pass {
     WebService webservice;
     QString updateError;
 
-    QImage imgBackground;
-    QImage imgFooter;
-    QImage imgIcon;
-    QImage imgLogo;
-    QImage imgStrip;
-    QImage imgThumbnail;
+    PassImage imgBackground;
+    PassImage imgFooter;
+    PassImage imgIcon;
+    PassImage imgLogo;
+    PassImage imgStrip;
+    PassImage imgThumbnail;
     bool haveStripImage;
+    bool haveBackgroundImage;
+
+    // precomputed sort keys, compared as plain integers. the lower bits hold a tie-breaker derived
+    // from the id, so passes with equal dates still have a fixed order.
+
+    quint64 sortKey;          // sorting date, newest first
+    quint64 expiryKey;        // expiration date, soonest first
+    quint64 styleKey;         // pass style, then sorting date
+    QString organizationKey;  // case folded organization name
+
+    void updateSortKeys();
 
     ~Pass()
     {
         qDebug() << "DESTRUCT PASS";
     }
-
-    explicit operator QVariant() const
-    {
-        QVariantMap m;
-        m.insert("id", id);
-        m.insert("bundleName", bundleName);
-        m.insert("bundleIndex", bundleIndex);
-        m.insert("bundleExpired", bundleExpired);
-        m.insert("bundleId", bundleId);
-        m.insert("modified", modified);
-        m.insert("filePath", filePath);
-        m.insert("standard", static_cast<QVariant>(standard));
-        m.insert("details", static_cast<QVariant>(details));
-        m.insert("webservice", static_cast<QVariant>(webservice));
-        m.insert("updateError", updateError);
-        m.insert("haveStripImage", haveStripImage);
-
-        QVariantList subPasses;
-
-        for (const auto& pass : bundlePasses) {
-            subPasses << static_cast<QVariant>(*pass);
-        }
-
-        m.insert("bundlePasses", subPasses);
-
-        return m;
-    }
 };
 
 using PassPtr = std::shared_ptr<Pass>;
 using PassList = std::vector<PassPtr>;
-using PassMap = std::map<QString, PassPtr>;
+using PassMap = QHash<QString, PassPtr>;
 
 using PassResult = std::variant<QString, PassPtr>;
 using BundleResult = std::variant<QString, PassList>;
@@ -275,7 +321,10 @@ public:
     Pkpass();
 
     PassResult openPass(const QFileInfo& info);
-    BundleResult extractBundle(const QFileInfo& info);
+    PassResult openPass(const QByteArray& data, const QFileInfo& info, const QDateTime& modified);
+    BundleResult openBundle(const QFileInfo& info);
+    BundleResult openBundle(const QByteArray& data, const QFileInfo& info,
+                            const QDateTime& modified);
 
     void setDefaultFont(QFont to)
     {
@@ -286,13 +335,15 @@ protected:
     QString readPass(PassPtr pass, QuaZip& archive);
     QJsonDocument readPassDocument(const QByteArray& data, QString& err);
     QString readImages(PassPtr pass, QuaZip& archive, const QStringList& archiveContents);
-    QString readImage(QImage* dest, QuaZip& archive, const QStringList& archiveContents,
+    QString readImage(PassImage* dest, QuaZip& archive, const QStringList& archiveContents,
                       QString imageName);
     QString readLocalization(PassPtr pass, QuaZip& archive, const QStringList& archiveContents);
     QString readLocalization(PassPtr pass, QuaZip& archive, const QString& localization);
 
     QString readPassStandard(PassPtr pass, QJsonObject& object);
     QString readPassBarcode(PassPtr pass, QJsonObject object);
+    void readPassLocations(PassPtr pass, QJsonArray array);
+    void readPassBeacons(PassPtr pass, QJsonArray array);
     QString readPassStyle(PassPtr pass, QJsonObject object);
     QString readPassStyleFields(QList<PassStyleField>& fields, QJsonArray object);
 
@@ -306,4 +357,12 @@ protected:
 
 } // namespace passes
 
+Q_DECLARE_METATYPE(passes::Barcode)
+Q_DECLARE_METATYPE(passes::Location)
+Q_DECLARE_METATYPE(passes::Beacon)
+Q_DECLARE_METATYPE(passes::WebService)
+Q_DECLARE_METATYPE(passes::Standard)
+Q_DECLARE_METATYPE(passes::PassStyleField)
+Q_DECLARE_METATYPE(passes::PassStyle)
+
 #endif // PKPASS_H
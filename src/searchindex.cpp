@@ -0,0 +1,192 @@
+// **************************************************************************
+// class SearchIndex
+// 19.10.2026
+// Inverted index for searching passes
+// **************************************************************************
+// MIT License
+// Copyright © 2021 Patrick Fial
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions: The above copyright notice and this
+// permission notice shall be included in all copies or substantial portions of the Software. THE
+// SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+// LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// **************************************************************************
+// includes
+// **************************************************************************
+
+#include "searchindex.h"
+
+#include <QLocale>
+
+namespace passes {
+// **************************************************************************
+// class SearchIndex
+// **************************************************************************
+
+SearchIndex::SearchIndex() : generation(0) {}
+
+// **************************************************************************
+// tokenize
+// **************************************************************************
+
+// lower case words without diacritics, so "zurich" finds "Zürich"
+
+QStringList SearchIndex::tokenize(const QString& text)
+{
+    QStringList tokens;
+    QString current;
+
+    for (const QChar& c : text.normalized(QString::NormalizationForm_KD)) {
+        if (c.isLetterOrNumber()) {
+            current += c.toCaseFolded();
+        } else if (!c.isMark() && !current.isEmpty()) {
+            tokens << current;
+            current.clear();
+        }
+    }
+
+    if (!current.isEmpty())
+        tokens << current;
+
+    return tokens;
+}
+
+// **************************************************************************
+// collect
+// **************************************************************************
+
+void SearchIndex::collect(QSet<QString>& tokens, const PassPtr& pass) const
+{
+    auto addText = [&tokens](const QString& text) {
+        for (const auto& token : tokenize(text))
+            tokens.insert(token);
+    };
+
+    auto addFields = [&addText](const QList<PassStyleField>& fields) {
+        for (const auto& field : fields) {
+            addText(field.label);
+            addText(field.value);
+        }
+    };
+
+    addText(pass->standard.organization);
+    addText(pass->standard.description);
+    addText(pass->standard.logoText);
+
+    addFields(pass->details.headerFields);
+    addFields(pass->details.primaryFields);
+    addFields(pass->details.secondaryFields);
+    addFields(pass->details.auxiliaryFields);
+    addFields(pass->details.backFields);
+
+    for (const auto& barcode : pass->standard.barcodes)
+        addText(barcode.altText);
+
+    // month and year, so a pass can be found by when it is used
+
+    if (pass->standard.expiresAt.isValid())
+        addText(QLocale().toString(pass->standard.expiresAt.date(), "MMMM yyyy"));
+
+    for (const auto& bundlePass : pass->bundlePasses)
+        collect(tokens, bundlePass);
+}
+
+// **************************************************************************
+// add
+// **************************************************************************
+
+void SearchIndex::add(const QString& id, const PassPtr& pass)
+{
+    remove(id);
+
+    QSet<QString> tokens;
+    collect(tokens, pass);
+
+    QStringList& list = words[id];
+
+    for (const auto& token : tokens) {
+        postings[token].insert(id);
+        list << token;
+    }
+
+    generation++;
+}
+
+// **************************************************************************
+// remove
+// **************************************************************************
+
+void SearchIndex::remove(const QString& id)
+{
+    auto it = words.find(id);
+
+    if (it == words.end())
+        return;
+
+    for (const auto& token : *it) {
+        auto posting = postings.find(token);
+
+        if (posting == postings.end())
+            continue;
+
+        posting->second.remove(id);
+
+        if (posting->second.isEmpty())
+            postings.erase(posting);
+    }
+
+    words.erase(it);
+    generation++;
+}
+
+// **************************************************************************
+// clear
+// **************************************************************************
+
+void SearchIndex::clear()
+{
+    postings.clear();
+    words.clear();
+    generation++;
+}
+
+// **************************************************************************
+// find
+// **************************************************************************
+
+// every word of the query must match (as prefix) a word of the pass
+
+QSet<QString> SearchIndex::find(const QString& query) const
+{
+    QSet<QString> result;
+    bool first = true;
+
+    for (const auto& token : tokenize(query)) {
+        QSet<QString> matches;
+
+        for (auto it = postings.lower_bound(token);
+             it != postings.end() && it->first.startsWith(token); it++)
+            matches.unite(it->second);
+
+        if (first)
+            result = matches;
+        else
+            result.intersect(matches);
+
+        first = false;
+
+        if (result.isEmpty())
+            break;
+    }
+
+    return result;
+}
+
+} // namespace passes
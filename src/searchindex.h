@@ -0,0 +1,70 @@
+// **************************************************************************
+// class SearchIndex
+// 19.10.2026
+// Inverted index for searching passes
+// **************************************************************************
+// MIT License
+// Copyright © 2021 Patrick Fial
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions: The above copyright notice and this
+// permission notice shall be included in all copies or substantial portions of the Software. THE
+// SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+// LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// **************************************************************************
+// includes
+// **************************************************************************
+
+#ifndef SEARCHINDEX_H
+#define SEARCHINDEX_H
+
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+
+#include "pkpass.h"
+
+#include <map>
+
+// **************************************************************************
+// class SearchIndex
+// **************************************************************************
+
+// maps every word found in a pass to the ids of the passes containing it. words are kept sorted,
+// so all words starting with a prefix are one contiguous range.
+
+namespace passes {
+class SearchIndex {
+public:
+    SearchIndex();
+
+    void add(const QString& id, const PassPtr& pass);
+    void remove(const QString& id);
+    void clear();
+
+    QSet<QString> find(const QString& query) const;
+
+    quint64 getGeneration() const
+    {
+        return generation;
+    }
+
+    static QStringList tokenize(const QString& text);
+
+private:
+    void collect(QSet<QString>& tokens, const PassPtr& pass) const;
+
+    std::map<QString, QSet<QString>> postings; // word -> pass ids
+    QHash<QString, QStringList> words;         // pass id -> words (for removal)
+    quint64 generation;
+};
+
+} // namespace passes
+
+#endif // SEARCHINDEX_H
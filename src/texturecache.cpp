@@ -0,0 +1,230 @@
+// **************************************************************************
+// class TextureCache
+// 19.10.2026
+// Shared scene graph textures for pass images
+// **************************************************************************
+// MIT License
+// Copyright © 2021 Patrick Fial
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions: The above copyright notice and this
+// permission notice shall be included in all copies or substantial portions of the Software. THE
+// SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+// LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// **************************************************************************
+// includes
+// **************************************************************************
+
+#include "texturecache.h"
+
+#include <QDebug>
+#include <QQuickWindow>
+
+namespace passes {
+// **************************************************************************
+// class TextureCache
+// **************************************************************************
+
+TextureCache* TextureCache::instance()
+{
+    static TextureCache cache;
+    return &cache;
+}
+
+// **************************************************************************
+// acquire
+// **************************************************************************
+
+QSGTexture* TextureCache::acquire(QQuickWindow* window, const QString& key, const QImage& image)
+{
+    if (!window || image.isNull())
+        return nullptr;
+
+    QMutexLocker lock(&mutex);
+
+    TextureKey textureKey(window, key);
+    TextureEntry* entry = entries.value(textureKey);
+
+    if (!entry) {
+        QSGTexture* texture = window->createTextureFromImage(image);
+
+        if (!texture)
+            return nullptr;
+
+        if (!windows.contains(window)) {
+            windows.insert(window);
+
+            // sceneGraphInvalidated is emitted on the render thread while the windows context is
+            // still current, so the textures are deleted right there. destroyed drops the
+            // pointer, so a new window allocated at the same address is tracked again.
+
+            QObject::connect(
+              window, &QQuickWindow::sceneGraphInvalidated, window,
+              [this, window]() { invalidate(window); }, Qt::DirectConnection);
+
+            QObject::connect(window, &QObject::destroyed, [this, window]() { forget(window); });
+        }
+
+        entry = new TextureEntry;
+        entry->key = textureKey;
+        entry->texture = texture;
+        entry->bytes = image.bytesPerLine() * image.height();
+
+        entries.insert(textureKey, entry);
+        bytesInUse += entry->bytes;
+
+        evict();
+    } else if (!entry->users) {
+        unused.erase(entry->unusedPos);
+    }
+
+    entry->users++;
+
+    return new SharedTexture(entry);
+}
+
+// **************************************************************************
+// release
+// **************************************************************************
+
+void TextureCache::release(TextureEntry* entry)
+{
+    QMutexLocker lock(&mutex);
+
+    if (--entry->users > 0)
+        return;
+
+    if (entry->orphaned) {
+        // the texture itself went with the windows scene graph already
+        delete entry;
+        return;
+    }
+
+    entry->unusedPos = unused.insert(unused.end(), entry);
+    evict();
+}
+
+// **************************************************************************
+// evict
+// **************************************************************************
+
+void TextureCache::evict()
+{
+    // textures still shown by some item are never dropped, so the budget can be exceeded
+    // temporarily while many distinct images are on screen
+
+    while (bytesInUse > budget && !unused.empty()) {
+        TextureEntry* entry = unused.front();
+        unused.pop_front();
+
+        entries.remove(entry->key);
+        bytesInUse -= entry->bytes;
+
+        delete entry->texture;
+        delete entry;
+    }
+}
+
+// **************************************************************************
+// invalidate
+// **************************************************************************
+
+void TextureCache::invalidate(QQuickWindow* window)
+{
+    QMutexLocker lock(&mutex);
+
+    for (auto it = entries.begin(); it != entries.end();) {
+        TextureEntry* entry = it.value();
+
+        if (entry->key.first != window) {
+            ++it;
+            continue;
+        }
+
+        bytesInUse -= entry->bytes;
+        it = entries.erase(it);
+
+        // the GL texture has to go now while the context is current, even if items still hold
+        // handles onto it. those handles are deleted later on, without a context.
+
+        delete entry->texture;
+        entry->texture = nullptr;
+
+        if (entry->users) {
+            entry->orphaned = true;
+            continue;
+        }
+
+        unused.erase(entry->unusedPos);
+        delete entry;
+    }
+}
+
+// **************************************************************************
+// forget
+// **************************************************************************
+
+void TextureCache::forget(QQuickWindow* window)
+{
+    // the scene graph is normally invalidated before the window is destroyed, so there are no
+    // textures left at this point. anything that is left is dropped without a context.
+
+    invalidate(window);
+
+    QMutexLocker lock(&mutex);
+    windows.remove(window);
+}
+
+// **************************************************************************
+// setBudget
+// **************************************************************************
+
+void TextureCache::setBudget(qint64 bytes)
+{
+    // textures may only be deleted on the render thread, so the new budget is applied with the
+    // next upload or release
+
+    QMutexLocker lock(&mutex);
+    budget = bytes;
+}
+
+// **************************************************************************
+// getBytesInUse
+// **************************************************************************
+
+qint64 TextureCache::getBytesInUse()
+{
+    QMutexLocker lock(&mutex);
+    return bytesInUse;
+}
+
+// **************************************************************************
+// class SharedTexture
+// **************************************************************************
+
+SharedTexture::~SharedTexture()
+{
+    TextureCache::instance()->release(entry);
+}
+
+void SharedTexture::bind()
+{
+    if (!entry->texture)
+        return;
+
+    // filtering is set per item on this handle, apply it to the shared texture before binding
+
+    entry->texture->setFiltering(filtering());
+    entry->texture->setMipmapFiltering(mipmapFiltering());
+    entry->texture->setHorizontalWrapMode(horizontalWrapMode());
+    entry->texture->setVerticalWrapMode(verticalWrapMode());
+    entry->texture->bind();
+}
+
+} // namespace passes
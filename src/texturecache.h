@@ -0,0 +1,164 @@
+// **************************************************************************
+// class TextureCache
+// 19.10.2026
+// Shared scene graph textures for pass images
+// **************************************************************************
+// MIT License
+// Copyright © 2021 Patrick Fial
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions: The above copyright notice and this
+// permission notice shall be included in all copies or substantial portions of the Software. THE
+// SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+// LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// **************************************************************************
+// includes
+// **************************************************************************
+
+#ifndef TEXTURECACHE_H
+#define TEXTURECACHE_H
+
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QPair>
+#include <QQuickImageProvider>
+#include <QSGTexture>
+#include <QSet>
+#include <QString>
+
+#include <list>
+
+class QQuickWindow;
+
+// **************************************************************************
+// class TextureCache
+// **************************************************************************
+
+namespace passes {
+using TextureKey = QPair<QQuickWindow*, QString>;
+
+// one uploaded texture, shared by all items showing the same image.
+// only touched on the render thread (apart from the budget). texture is null once the windows
+// scene graph was invalidated while items still held handles onto it.
+
+struct TextureEntry {
+    TextureKey key;
+    QSGTexture* texture = nullptr;
+    qint64 bytes = 0;
+    int users = 0;
+    bool orphaned = false;
+    std::list<TextureEntry*>::iterator unusedPos;
+};
+
+class TextureCache {
+public:
+    static TextureCache* instance();
+
+    QSGTexture* acquire(QQuickWindow* window, const QString& key, const QImage& image);
+    void release(TextureEntry* entry);
+
+    void setBudget(qint64 bytes);
+    qint64 getBytesInUse();
+
+private:
+    TextureCache() = default;
+
+    void evict();
+    void invalidate(QQuickWindow* window);
+    void forget(QQuickWindow* window);
+
+    QMutex mutex;
+    QHash<TextureKey, TextureEntry*> entries;
+    QSet<QQuickWindow*> windows;
+    std::list<TextureEntry*> unused; // least recently used first
+    qint64 budget = 48 * 1024 * 1024;
+    qint64 bytesInUse = 0;
+};
+
+// **************************************************************************
+// class SharedTexture
+// **************************************************************************
+
+// lightweight per-item handle onto a shared texture. the scene graph owns and deletes it, which
+// releases the shared texture again.
+
+class SharedTexture : public QSGTexture {
+public:
+    SharedTexture(TextureEntry* entry) : entry(entry) {}
+    ~SharedTexture() override;
+
+    int textureId() const override
+    {
+        return entry->texture ? entry->texture->textureId() : 0;
+    }
+    QSize textureSize() const override
+    {
+        return entry->texture ? entry->texture->textureSize() : QSize();
+    }
+    bool hasAlphaChannel() const override
+    {
+        return entry->texture ? entry->texture->hasAlphaChannel() : false;
+    }
+    bool hasMipmaps() const override
+    {
+        return entry->texture ? entry->texture->hasMipmaps() : false;
+    }
+    bool isAtlasTexture() const override
+    {
+        return entry->texture ? entry->texture->isAtlasTexture() : false;
+    }
+    QRectF normalizedTextureSubRect() const override
+    {
+        return entry->texture ? entry->texture->normalizedTextureSubRect() : QRectF(0, 0, 1, 1);
+    }
+    QSGTexture* removedFromAtlas() const override
+    {
+        return entry->texture ? entry->texture->removedFromAtlas() : nullptr;
+    }
+
+    void bind() override;
+
+private:
+    TextureEntry* entry;
+};
+
+// **************************************************************************
+// class SharedTextureFactory
+// **************************************************************************
+
+class SharedTextureFactory : public QQuickTextureFactory {
+public:
+    SharedTextureFactory(const QString& key, const QImage& image) : key(key), img(image) {}
+
+    QSGTexture* createTexture(QQuickWindow* window) const override
+    {
+        return TextureCache::instance()->acquire(window, key, img);
+    }
+    QSize textureSize() const override
+    {
+        return img.size();
+    }
+    int textureByteCount() const override
+    {
+        return img.bytesPerLine() * img.height();
+    }
+    QImage image() const override
+    {
+        return img;
+    }
+
+private:
+    QString key;
+    QImage img;
+};
+
+} // namespace passes
+
+#endif // TEXTURECACHE_H
@@ -0,0 +1,184 @@
+// **************************************************************************
+// class ThumbnailCache
+// 19.10.2026
+// Card sized, premultiplied pass images persisted on disk
+// **************************************************************************
+// MIT License
+// Copyright © 2021 Patrick Fial
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions: The above copyright notice and this
+// permission notice shall be included in all copies or substantial portions of the Software. THE
+// SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+// LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// **************************************************************************
+// includes
+// **************************************************************************
+
+#include "thumbnailcache.h"
+#include "imagecache.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+namespace passes {
+// thumbnails are stored as raw pixel data, so loading them is a single read without any
+// decoding or format conversion before the texture upload
+
+static const quint32 thumbnailMagic = 0x42485450; // "PTHB"
+
+// **************************************************************************
+// class ThumbnailCache
+// **************************************************************************
+
+ThumbnailCache::ThumbnailCache() : ready(false)
+{
+    QString cachePath = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+
+    if (cachePath.isEmpty())
+        return;
+
+    dir.setPath(cachePath + "/thumbnails");
+    ready = dir.exists() || dir.mkpath(dir.path());
+
+    if (!ready)
+        qDebug() << "Thumbnail cache directory unavailable: " << dir.path();
+}
+
+ThumbnailCache* ThumbnailCache::instance()
+{
+    static ThumbnailCache cache;
+    return &cache;
+}
+
+// **************************************************************************
+// get
+// **************************************************************************
+
+QImage ThumbnailCache::get(const ImageHandle& image, const QSize& scaledSize)
+{
+    if (!image)
+        return QImage();
+
+    QSize size = scaledSize.isValid() ? scaledSize : image->size;
+    QByteArray key = "thumbnail/" + image->hash + "@" + QByteArray::number(size.width()) + "x"
+                     + QByteArray::number(size.height());
+
+    QImage thumbnail = ImageCache::instance()->find(key);
+
+    if (!thumbnail.isNull())
+        return thumbnail;
+
+    QString path = filePath(image->hash, size);
+
+    if (ready)
+        thumbnail = load(path);
+
+    if (thumbnail.isNull()) {
+        // decoded straight to the thumbnail size, the image cache only gets the thumbnail
+
+        thumbnail = ImageStore::instance()->read(image, size)
+                      .convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+        if (ready && !thumbnail.isNull())
+            save(path, thumbnail);
+    }
+
+    ImageCache::instance()->insert(key, thumbnail);
+
+    return thumbnail;
+}
+
+// **************************************************************************
+// prune
+// **************************************************************************
+
+void ThumbnailCache::prune()
+{
+    // drop thumbnails of images no longer referenced by any pass. runs on the store thread while
+    // the image provider may be using dir, so the listing goes through a copy of its own.
+
+    if (!ready)
+        return;
+
+    QDir pruneDir(dir.path());
+
+    for (const QString& fileName : pruneDir.entryList(QDir::Files | QDir::NoDotAndDotDot)) {
+        QByteArray hash = QByteArray::fromHex(fileName.section('_', 0, 0).toLatin1());
+
+        if (!ImageStore::instance()->contains(hash))
+            pruneDir.remove(fileName);
+    }
+}
+
+// **************************************************************************
+// filePath
+// **************************************************************************
+
+QString ThumbnailCache::filePath(const QByteArray& hash, const QSize& size) const
+{
+    return dir.filePath(QString::fromLatin1(hash.toHex()) + "_" + QString::number(size.width())
+                        + "x" + QString::number(size.height()) + ".raw");
+}
+
+// **************************************************************************
+// load
+// **************************************************************************
+
+QImage ThumbnailCache::load(const QString& path) const
+{
+    QFile file(path);
+
+    if (!file.open(QIODevice::ReadOnly))
+        return QImage();
+
+    quint32 header[4]; // magic, width, height, bytes per line
+
+    if (file.read(reinterpret_cast<char*>(header), sizeof(header)) != sizeof(header)
+        || header[0] != thumbnailMagic)
+        return QImage();
+
+    QImage image(header[1], header[2], QImage::Format_ARGB32_Premultiplied);
+
+    if (image.isNull() || image.bytesPerLine() != static_cast<int>(header[3]))
+        return QImage();
+
+    qint64 bytes = qint64(header[3]) * header[2];
+
+    if (file.read(reinterpret_cast<char*>(image.bits()), bytes) != bytes)
+        return QImage();
+
+    return image;
+}
+
+// **************************************************************************
+// save
+// **************************************************************************
+
+void ThumbnailCache::save(const QString& path, const QImage& image) const
+{
+    QSaveFile file(path);
+
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+
+    quint32 header[4] = {thumbnailMagic, quint32(image.width()), quint32(image.height()),
+                         quint32(image.bytesPerLine())};
+
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(image.constBits()),
+               qint64(image.bytesPerLine()) * image.height());
+
+    if (!file.commit())
+        qDebug() << "Failed to write thumbnail " << path << ": " << file.errorString();
+}
+
+} // namespace passes
@@ -0,0 +1,58 @@
+// **************************************************************************
+// class ThumbnailCache
+// 19.10.2026
+// Card sized, premultiplied pass images persisted on disk
+// **************************************************************************
+// MIT License
+// Copyright © 2021 Patrick Fial
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions: The above copyright notice and this
+// permission notice shall be included in all copies or substantial portions of the Software. THE
+// SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+// LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// **************************************************************************
+// includes
+// **************************************************************************
+
+#ifndef THUMBNAILCACHE_H
+#define THUMBNAILCACHE_H
+
+#include <QDir>
+#include <QImage>
+#include <QSize>
+
+#include "imagestore.h"
+
+// **************************************************************************
+// class ThumbnailCache
+// **************************************************************************
+
+namespace passes {
+class ThumbnailCache {
+public:
+    static ThumbnailCache* instance();
+
+    QImage get(const ImageHandle& image, const QSize& scaledSize);
+    void prune();
+
+private:
+    ThumbnailCache();
+
+    QString filePath(const QByteArray& hash, const QSize& size) const;
+    QImage load(const QString& path) const;
+    void save(const QString& path, const QImage& image) const;
+
+    QDir dir;
+    bool ready;
+};
+
+} // namespace passes
+
+#endif // THUMBNAILCACHE_H
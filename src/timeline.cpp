@@ -0,0 +1,211 @@
+// **************************************************************************
+// class Timeline
+// 19.10.2026
+// Interval tree over the relevance periods of passes
+// **************************************************************************
+// MIT License
+// Copyright © 2021 Patrick Fial
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions: The above copyright notice and this
+// permission notice shall be included in all copies or substantial portions of the Software. THE
+// SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+// LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// **************************************************************************
+// includes
+// **************************************************************************
+
+#include "timeline.h"
+
+namespace passes {
+// **************************************************************************
+// struct Node
+// **************************************************************************
+
+struct Timeline::Node {
+    Interval interval;
+    quint32 priority;
+    qint64 maxEnd;
+    NodePtr left, right;
+};
+
+// **************************************************************************
+// class Timeline
+// **************************************************************************
+
+Timeline::Timeline() : random(std::random_device()()) {}
+
+Timeline::~Timeline() = default;
+
+// **************************************************************************
+// helpers
+// **************************************************************************
+
+bool Timeline::less(const Interval& a, const Interval& b)
+{
+    return a.start != b.start ? a.start < b.start : a.id < b.id;
+}
+
+void Timeline::update(Node* node)
+{
+    node->maxEnd = node->interval.end;
+
+    if (node->left)
+        node->maxEnd = qMax(node->maxEnd, node->left->maxEnd);
+    if (node->right)
+        node->maxEnd = qMax(node->maxEnd, node->right->maxEnd);
+}
+
+// splits into nodes ordered before key (left) and the rest (right)
+
+void Timeline::split(NodePtr node, const Interval& key, NodePtr& left, NodePtr& right)
+{
+    if (!node) {
+        left.reset();
+        right.reset();
+        return;
+    }
+
+    if (less(node->interval, key)) {
+        split(std::move(node->right), key, node->right, right);
+        update(node.get());
+        left = std::move(node);
+    } else {
+        split(std::move(node->left), key, left, node->left);
+        update(node.get());
+        right = std::move(node);
+    }
+}
+
+Timeline::NodePtr Timeline::merge(NodePtr left, NodePtr right)
+{
+    if (!left)
+        return right;
+    if (!right)
+        return left;
+
+    if (left->priority > right->priority) {
+        left->right = merge(std::move(left->right), std::move(right));
+        update(left.get());
+        return left;
+    }
+
+    right->left = merge(std::move(left), std::move(right->left));
+    update(right.get());
+    return right;
+}
+
+// **************************************************************************
+// insert
+// **************************************************************************
+
+void Timeline::insert(const QString& id, qint64 start, qint64 end)
+{
+    remove(id);
+
+    Interval interval {start, qMax(start, end), id};
+
+    NodePtr node(new Node {interval, (quint32)random(), interval.end, nullptr, nullptr});
+    NodePtr left, right;
+
+    split(std::move(root), interval, left, right);
+    root = merge(merge(std::move(left), std::move(node)), std::move(right));
+
+    intervals.insert(id, interval);
+}
+
+// **************************************************************************
+// remove
+// **************************************************************************
+
+void Timeline::remove(const QString& id)
+{
+    auto it = intervals.find(id);
+
+    if (it == intervals.end())
+        return;
+
+    // cut out exactly the one node: everything before it, the node itself, everything after
+
+    Interval after = *it;
+    after.id += QChar(0);
+
+    NodePtr left, middle, right;
+
+    split(std::move(root), *it, left, middle);
+    split(std::move(middle), after, middle, right);
+
+    root = merge(std::move(left), std::move(right));
+
+    intervals.erase(it);
+}
+
+// **************************************************************************
+// clear
+// **************************************************************************
+
+void Timeline::clear()
+{
+    root.reset();
+    intervals.clear();
+}
+
+// **************************************************************************
+// overlapping
+// **************************************************************************
+
+void Timeline::collect(const Node* node, qint64 from, qint64 to, QVector<Interval>& result)
+{
+    // nothing in this subtree ends late enough
+
+    if (!node || node->maxEnd < from)
+        return;
+
+    collect(node->left.get(), from, to, result);
+
+    // everything to the right starts even later
+
+    if (node->interval.start > to)
+        return;
+
+    if (node->interval.end >= from)
+        result << node->interval;
+
+    collect(node->right.get(), from, to, result);
+}
+
+QVector<Timeline::Interval> Timeline::overlapping(qint64 from, qint64 to) const
+{
+    QVector<Interval> result;
+    collect(root.get(), from, to, result);
+    return result;
+}
+
+// **************************************************************************
+// nextStartAfter
+// **************************************************************************
+
+qint64 Timeline::nextStartAfter(qint64 time) const
+{
+    qint64 next = -1;
+    const Node* node = root.get();
+
+    while (node) {
+        if (node->interval.start > time) {
+            next = node->interval.start;
+            node = node->left.get();
+        } else {
+            node = node->right.get();
+        }
+    }
+
+    return next;
+}
+
+} // namespace passes
@@ -0,0 +1,88 @@
+// **************************************************************************
+// class Timeline
+// 19.10.2026
+// Interval tree over the relevance periods of passes
+// **************************************************************************
+// MIT License
+// Copyright © 2021 Patrick Fial
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions: The above copyright notice and this
+// permission notice shall be included in all copies or substantial portions of the Software. THE
+// SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+// LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// **************************************************************************
+// includes
+// **************************************************************************
+
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+#include <memory>
+#include <random>
+
+// **************************************************************************
+// class Timeline
+// **************************************************************************
+
+// augmented treap over [start, end] intervals (msecs since epoch), ordered by start. every node
+// knows the latest end within its subtree, so overlap queries skip whole subtrees and run in
+// O(log n + k). insertions and removals are O(log n).
+
+namespace passes {
+class Timeline {
+public:
+    struct Interval {
+        qint64 start;
+        qint64 end;
+        QString id;
+    };
+
+    Timeline();
+    ~Timeline();
+
+    void insert(const QString& id, qint64 start, qint64 end);
+    void remove(const QString& id);
+    void clear();
+
+    int getCount() const
+    {
+        return intervals.size();
+    }
+
+    // intervals overlapping [from, to], ordered by start
+
+    QVector<Interval> overlapping(qint64 from, qint64 to) const;
+
+    // earliest start after the given time, -1 if there is none
+
+    qint64 nextStartAfter(qint64 time) const;
+
+private:
+    struct Node;
+    using NodePtr = std::unique_ptr<Node>;
+
+    static bool less(const Interval& a, const Interval& b);
+    static void update(Node* node);
+    static void split(NodePtr node, const Interval& key, NodePtr& left, NodePtr& right);
+    static NodePtr merge(NodePtr left, NodePtr right);
+    static void collect(const Node* node, qint64 from, qint64 to, QVector<Interval>& result);
+
+    NodePtr root;
+    QHash<QString, Interval> intervals; // id -> interval, needed to find nodes for removal
+    std::mt19937 random;
+};
+
+} // namespace passes
+
+#endif // TIMELINE_H
@@ -0,0 +1,253 @@
+// **************************************************************************
+// class UpNextModel
+// 19.10.2026
+// Passes becoming relevant within the next hours
+// **************************************************************************
+// MIT License
+// Copyright © 2021 Patrick Fial
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions: The above copyright notice and this
+// permission notice shall be included in all copies or substantial portions of the Software. THE
+// SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+// LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// **************************************************************************
+// includes
+// **************************************************************************
+
+#include "upnextmodel.h"
+#include "passesmodel.h"
+
+namespace passes {
+// like the expiry scheduler, never rely on the monotonic timer for longer than this
+
+static const qint64 maxInterval = 15 * 60 * 1000;
+static const qint64 msecsPerHour = 60 * 60 * 1000;
+
+// **************************************************************************
+// class UpNextModel
+// **************************************************************************
+
+UpNextModel::UpNextModel(PassesModel* passes)
+  : QAbstractListModel(passes), passes(passes), hours(24), batching(0)
+{
+    timer.setSingleShot(true);
+    timer.setTimerType(Qt::VeryCoarseTimer);
+
+    connect(&timer, &QTimer::timeout, this, &UpNextModel::refresh);
+}
+
+// **************************************************************************
+// data
+// **************************************************************************
+
+QVariant UpNextModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= mItems.size())
+        return QVariant();
+
+    const auto& item = mItems[index.row()];
+
+    switch (role) {
+        case Qt::DisplayRole:
+        case PassRole: {
+            auto pass = passes->getPass(item.id);
+            return pass ? QVariant::fromValue(passes->getObject(pass)) : QVariant();
+        }
+        case RelevantDateRole:
+            return QDateTime::fromMSecsSinceEpoch(item.start);
+        case EndDateRole:
+            return QDateTime::fromMSecsSinceEpoch(item.end);
+        default:
+            break;
+    }
+
+    return QVariant();
+}
+
+// **************************************************************************
+// rowCount
+// **************************************************************************
+
+int UpNextModel::rowCount(const QModelIndex& /*parent*/) const
+{
+    return mItems.size();
+}
+
+// **************************************************************************
+// roleNames
+// **************************************************************************
+
+QHash<int, QByteArray> UpNextModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[PassRole] = "pass";
+    roles[RelevantDateRole] = "relevantDate";
+    roles[EndDateRole] = "endDate";
+    return roles;
+}
+
+// **************************************************************************
+// currentlyValid
+// **************************************************************************
+
+QStringList UpNextModel::currentlyValid() const
+{
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    QStringList ids;
+
+    for (const auto& interval : timeline.overlapping(now, now))
+        ids << interval.id;
+
+    return ids;
+}
+
+// **************************************************************************
+// setHours
+// **************************************************************************
+
+void UpNextModel::setHours(int to)
+{
+    if (to == hours || to <= 0)
+        return;
+
+    hours = to;
+    refresh();
+
+    emit hoursChanged();
+}
+
+// **************************************************************************
+// add
+// **************************************************************************
+
+// a pass is relevant from its relevant date until it expires. bundles span all of their passes.
+
+void UpNextModel::add(const PassPtr& pass)
+{
+    qint64 start = -1, end = -1;
+
+    auto extend = [&start, &end](const PassPtr& p) {
+        if (p->standard.relevantDate.isEmpty() || !p->sortingDate.isValid())
+            return;
+
+        qint64 s = p->sortingDate.toMSecsSinceEpoch();
+        qint64 e = p->standard.expiresAt.isValid() ? p->standard.expiresAt.toMSecsSinceEpoch() : s;
+
+        start = start < 0 ? s : qMin(start, s);
+        end = qMax(end, e);
+    };
+
+    extend(pass);
+
+    for (const auto& bundlePass : pass->bundlePasses)
+        extend(bundlePass);
+
+    if (start < 0)
+        timeline.remove(pass->id);
+    else
+        timeline.insert(pass->id, start, end);
+
+    if (!batching)
+        refresh();
+}
+
+void UpNextModel::remove(const QString& id)
+{
+    timeline.remove(id);
+
+    if (!batching)
+        refresh();
+}
+
+void UpNextModel::clear()
+{
+    timeline.clear();
+
+    if (!batching)
+        refresh();
+}
+
+// **************************************************************************
+// beginBatch/endBatch
+// **************************************************************************
+
+void UpNextModel::beginBatch()
+{
+    batching++;
+}
+
+void UpNextModel::endBatch()
+{
+    if (--batching == 0)
+        refresh();
+}
+
+// **************************************************************************
+// refresh
+// **************************************************************************
+
+// queries the timeline and applies only the difference to the current rows. afterwards the
+// timer is armed for the next moment a pass enters or leaves the window.
+
+void UpNextModel::refresh()
+{
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    qint64 window = hours * msecsPerHour;
+    auto items = timeline.overlapping(now, now + window);
+
+    auto before = [](const Timeline::Interval& a, const Timeline::Interval& b) {
+        return a.start != b.start ? a.start < b.start : a.id < b.id;
+    };
+
+    int oldCount = mItems.size();
+    int i = 0, j = 0;
+
+    while (i < mItems.size() || j < items.size()) {
+        if (j >= items.size() || (i < mItems.size() && before(mItems[i], items[j]))) {
+            beginRemoveRows(QModelIndex(), i, i);
+            mItems.remove(i);
+            endRemoveRows();
+        } else if (i >= mItems.size() || before(items[j], mItems[i])) {
+            beginInsertRows(QModelIndex(), i, i);
+            mItems.insert(i, items[j]);
+            endInsertRows();
+            i++, j++;
+        } else {
+            if (mItems[i].end != items[j].end) {
+                mItems[i] = items[j];
+                emit dataChanged(index(i), index(i));
+            }
+
+            i++, j++;
+        }
+    }
+
+    if (oldCount != mItems.size())
+        emit countChanged();
+
+    // next change: a listed pass ends, or the next pass enters the window
+
+    qint64 next = -1;
+
+    for (const auto& item : mItems)
+        next = next < 0 ? item.end + 1 : qMin(next, item.end + 1);
+
+    qint64 nextStart = timeline.nextStartAfter(now + window);
+
+    if (nextStart >= 0)
+        next = next < 0 ? nextStart - window : qMin(next, nextStart - window);
+
+    if (next < 0)
+        timer.stop();
+    else
+        timer.start((int)qBound<qint64>(0, next - now, maxInterval));
+}
+
+} // namespace passes
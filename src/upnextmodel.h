@@ -0,0 +1,98 @@
+// **************************************************************************
+// class UpNextModel
+// 19.10.2026
+// Passes becoming relevant within the next hours
+// **************************************************************************
+// MIT License
+// Copyright © 2021 Patrick Fial
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+// associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions: The above copyright notice and this
+// permission notice shall be included in all copies or substantial portions of the Software. THE
+// SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT
+// LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// **************************************************************************
+// includes
+// **************************************************************************
+
+#ifndef UPNEXTMODEL_H
+#define UPNEXTMODEL_H
+
+#include <QAbstractListModel>
+#include <QTimer>
+
+#include "pkpass.h"
+#include "timeline.h"
+
+// **************************************************************************
+// class UpNextModel
+// **************************************************************************
+
+// lists passes whose relevance period (relevant date until expiration) overlaps the next hours,
+// ordered by relevant date. passes without relevant date are not part of the timeline.
+
+namespace passes {
+class PassesModel;
+
+class UpNextModel : public QAbstractListModel {
+    enum RoleNames { PassRole = Qt::UserRole + 1, RelevantDateRole, EndDateRole };
+
+    Q_OBJECT
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+    Q_PROPERTY(int hours READ getHours WRITE setHours NOTIFY hoursChanged)
+
+public:
+    explicit UpNextModel(PassesModel* passes);
+
+    // QAbstractListModel
+
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const;
+    QHash<int, QByteArray> roleNames() const;
+
+    // QML interaction
+
+    Q_INVOKABLE QStringList currentlyValid() const;
+
+    int getHours() const
+    {
+        return hours;
+    }
+    void setHours(int to);
+
+    // timeline maintenance (by PassesModel)
+
+    void add(const PassPtr& pass);
+    void remove(const QString& id);
+    void clear();
+
+    // while batching, the rows are only refreshed once at the end
+
+    void beginBatch();
+    void endBatch();
+
+public slots:
+    void refresh();
+
+signals:
+    void countChanged();
+    void hoursChanged();
+
+private:
+    PassesModel* passes;
+    Timeline timeline;
+    QVector<Timeline::Interval> mItems;
+    int hours;
+    int batching;
+    QTimer timer;
+};
+
+} // namespace passes
+
+#endif // UPNEXTMODEL_H